@@ -15,6 +15,16 @@
 ///
 ///               Img<char>   img2(rows,clms,bigBuf);  // user-supplied buffer
 ///
+///          A user-supplied buffer may also be a VIEW on a sub-region of a bigger image
+///          (ROI of cv::Mat, padded driver buffer , pyramid level ...):
+///
+///               Img<char>   img3(rows,clms,bigBuf,rowBytes,begRow,begClm);
+///
+///          rowBytes is the distance in bytes between 2 consecutive rows (it can be > clms),
+///          begRow/begClm is the position of the view's [0][0] in the coordinates of the
+///          whole image. It is returned by getBegRow()/getBegClm() and ImgVectorizer
+///          adds it to all produced points, so the curves are in whole-image coordinates.
+///
 ///          It supports brackets operations and filling the Img with one particular pixel.
 ///          Copy operations (Ctor and assignment) are deep copys.
 ///
@@ -84,6 +94,8 @@
 ///       | size_t  clms                     |
 ///       | PixBox* data (mostly PixBox is X)|----> points to array allocated in heap
 ///       | bool    myBuf                    |      or supplied as hint (when myBuf==false)
+///       | size_t  step  (PixBoxes in row)  |
+///       | int     begRow , begClm          |
 ///       *================================================*
 ///       | const X* operator[](int r) const               |
 ///       |       X* operator[](int r)                     |
@@ -100,6 +112,8 @@
 ///       | bool  isEqual(rowNo,pixel) const               |
 ///       | bool  isEqual      (pixel) const               |
 ///       | int   pixBoxesInRow() const                    |
+///       | int   rowstride() const                        |
+///       | int   getBegRow() , getBegClm() const          |
 ///       *================================================*
 ///       | static bool rowsRequal(rowAptr,rowBptr,n)|
 ///       | static int  privPixBoxesInRow(cols)      |
@@ -511,7 +525,8 @@ public:
     private :
     void allocImg_set_data()
     {
-        data = (rows*cols==0 ? nullptr : new PixBox [rows*pixBoxesInRow()]);
+        step = pixBoxesInRow();
+        data = (rows*cols==0 ? nullptr : new PixBox [rows*step]);
     }
     
     void dealloc() {
@@ -525,7 +540,7 @@ public:
 public:
     ~ImgBase()        {  dbgReport(data ? 0 : 1); dealloc(); }
     
-    ImgBase()  : /*ImgBaseStorage(),*/ rows(0) , cols(0), data(nullptr), myBuf(true)
+    ImgBase()  : /*ImgBaseStorage(),*/ rows(0) , cols(0), data(nullptr), myBuf(true), step(0), begRow(0), begClm(0)
     {  dbgReport(2);}
     
     ImgBase(size_t r, size_t c)   // c-tor
@@ -533,6 +548,7 @@ public:
     rows(r), cols(c)
     , data(nullptr)
     , myBuf(true)
+    , step(0), begRow(0), begClm(0)
     {
         allocImg_set_data();
         dbgReport(3);
@@ -544,7 +560,22 @@ public:
     rows(r), cols(c)
     , data(reinterpret_cast<PixBox*>(data))
     , myBuf(false)
+    , step(pixBoxesInRow()), begRow(0), begClm(0)
+    {
+        dbgReport(3);
+    }
+    
+    // view on memory already allocated by caller
+    // rowBytes  - distance in bytes between rows , must be a multiple of sizeof(PixBox)
+    // begRow/begClm - position of the view in the whole image
+    ImgBase(size_t r, size_t c, void* data, size_t rowBytes, int begRow = 0, int begClm = 0)   // c-tor
+    : // ImgBaseStorage()
+    rows(r), cols(c)
+    , data(reinterpret_cast<PixBox*>(data))
+    , myBuf(false)
+    , step(rowBytes/sizeof(PixBox)), begRow(begRow), begClm(begClm)
     {
+        assert(rowBytes % sizeof(PixBox) == 0 && step >= size_t(pixBoxesInRow()));
         dbgReport(3);
     }
     
@@ -556,6 +587,7 @@ public:
     rows(img.rows), cols(img.cols)
     , data (img.data)
     , myBuf(img.myBuf)
+    , step(img.step), begRow(img.begRow), begClm(img.begClm)
     {
         if (myBuf)
         {
@@ -589,6 +621,7 @@ public:
     rows (rhs.rows), cols(rhs.cols)
     , data (rhs.data)     // just copy pointer
     , myBuf(rhs.myBuf)
+    , step (rhs.step), begRow(rhs.begRow), begClm(rhs.begClm)
     {
         // !!! temporary obj CAN be on user-buffer
         rhs.data = nullptr;
@@ -629,23 +662,25 @@ public:
             this->cols = c;
             if (myBuf)
                 allocImg_set_data();
+            else if (step < size_t(pixBoxesInRow()))
+                step = pixBoxesInRow();
         }
     }
     
     
-    PixelPtr operator [] (size_t i)        { assert(rowCk(i)); return makePixelPtr<     PixelPtr>(data+i*pixBoxesInRow());}
+    PixelPtr operator [] (size_t i)        { assert(rowCk(i)); return makePixelPtr<     PixelPtr>(data+i*step);}
     ConstPixelPtr operator [] (size_t i) const  {
-        assert(rowCk(i)); return makePixelPtr<ConstPixelPtr>(data+i*pixBoxesInRow());
+        assert(rowCk(i)); return makePixelPtr<ConstPixelPtr>(data+i*step);
     }
     
     int    getHeight () const                   { return int(rows);}
     int    getWidth  () const                   { return int(cols);}
     
-    int    getBegClm() const                    { return 0;}
-    int    getBegRow() const                    { return 0;}
+    int    getBegClm() const                    { return begClm;}
+    int    getBegRow() const                    { return begRow;}
     
-    int    getEndClm() const                    { return int(cols);}
-    int    getEndRow() const                    { return int(rows);}
+    int    getEndClm() const                    { return begClm + int(cols);}
+    int    getEndRow() const                    { return begRow + int(rows);}
     
     float  getStepClm() const                   { return 1.0f;}
     float  getStepRow() const                   { return 1.0f;}
@@ -653,6 +688,9 @@ public:
     // get number of bytes in row
     int    rowsize() const                      { return pixBoxesInRow()*int(sizeof(PixBox));}
     
+    // get distance in bytes between rows (== rowsize() unless it is a view)
+    int    rowstride() const                    { return int(step*sizeof(PixBox));}
+    
     template <class AnyPixelPtr>
     void rowcpy(size_t r, AnyPixelPtr from, bool flipX = false)   {
         
@@ -685,7 +723,7 @@ public:
             ___rowcpy(row,from,int(cols),(Pix*)nullptr, flipX);
     }
     
-    void rowset(size_t r, Pix pix)              { privSetRowPix(data+r*pixBoxesInRow() , pix);}
+    void rowset(size_t r, Pix pix)              { privSetRowPix(data+r*step , pix);}
     
     void rownot(size_t r) {
         //    int nBoxesInRow = pixBoxesInRow();
@@ -733,6 +771,7 @@ public:
         cols = ::getWidth (imgFrom);
         allocImg_set_data();
         myBuf = true;   // so released by destructor
+        begRow = begClm = 0;
         fillFrom(imgFrom, flipY, flipX);
     }
     
@@ -751,8 +790,8 @@ public:
         return true;
     }
     
-    const PixBox* pixBoxRowPtr(size_t r) const  { return data + r*pixBoxesInRow();}
-    PixBox* pixBoxRowPtr(size_t r)        { return data + r*pixBoxesInRow();}
+    const PixBox* pixBoxRowPtr(size_t r) const  { return data + r*step;}
+    PixBox* pixBoxRowPtr(size_t r)        { return data + r*step;}
     
     bool isEqual(size_t r, Pix pix) const
     {
@@ -779,6 +818,10 @@ protected:
     
     bool      myBuf;
     
+    size_t    step;     // # of PixBoxes between rows
+    int       begRow;   // position of [0][0] in the whole image
+    int       begClm;
+    
 private:
     
     static int privPixBoxesInRow(size_t cols) { return int(cols + base::pixelsInBox_e - 1)/pixelsInBox_e; }
@@ -801,6 +844,7 @@ ImgBase<BoolTrue>::ImgBase(size_t rows, size_t cols)   // c-tor
 rows(rows), cols(cols)
 , data(nullptr)
 , myBuf(true)
+, step(0), begRow(0), begClm(0)
 {
     dbgReport(3);
 }
@@ -812,6 +856,7 @@ ImgBase<BoolTrue>::ImgBase(const ImgBase<BoolTrue>& img)   // copy c-tor special
 rows(img.rows), cols(img.cols)
 , data(nullptr)
 , myBuf(true)
+, step(0), begRow(img.begRow), begClm(img.begClm)
 {
     dbgReport(3);
 }
@@ -870,6 +915,8 @@ public:
     Img()                                      : ImgBase<Pix>()                 { }
     Img(size_t rows, size_t cols)              : ImgBase<Pix>(rows,cols)        { }
     Img(size_t rows, size_t cols,void* data)   : ImgBase<Pix>(rows,cols, data)  { }
+    Img(size_t rows, size_t cols,void* data, size_t rowBytes, int begRow = 0, int begClm = 0)
+    : ImgBase<Pix>(rows,cols, data, rowBytes, begRow, begClm)  { }
     Img(const Img& img)                        : ImgBase<Pix>(img)              { }
     
     Img<Pixel>& operator=(const Img<Pixel>& img)           { if(this!=&img) ImgBase<Pixel>::operator=(img);return *this;}
@@ -924,6 +971,19 @@ inline int getHeight(const Img<Pix>& p)    { return p.getHeight();}
 template<class Pix>
 inline int getWidth (const Img<Pix>& p)    { return p.getWidth();}
 
+// position of [0][0] in the whole image , 0 for anything that is not a view
+template<class DoublyBracketable>
+inline int getBegRow(const DoublyBracketable&)    { return 0;}
+
+template<class DoublyBracketable>
+inline int getBegClm(const DoublyBracketable&)    { return 0;}
+
+template<class Pix>
+inline int getBegRow(const Img<Pix>& p)    { return p.getBegRow();}
+
+template<class Pix>
+inline int getBegClm(const Img<Pix>& p)    { return p.getBegClm();}
+
 template<class Pix>
 inline int getBits  (const Img<Pix>& p)    {
     typedef typename Img<Pix>::PixelPtr PixelPtr;
@@ -1058,6 +1118,8 @@ public:
     Img()                                 : ImgBase<bool>()                 { }
     Img(size_t rows, size_t cols)               : ImgBase<bool>(rows,cols)        { }
     Img(size_t rows, size_t cols, void* data)   : ImgBase<bool>(rows,cols, data)  { }
+    Img(size_t rows, size_t cols, void* data, size_t rowBytes, int begRow = 0, int begClm = 0)
+    : ImgBase<bool>(rows,cols, data, rowBytes, begRow, begClm)  { }
     Img(const Img& img)                   : ImgBase<bool>(img)              { }
     
     void operator=(const Img& img)   { ImgBase<bool>::operator=(img);}
@@ -40,6 +40,15 @@
 ///
 /// iv.set0value(anyZeroValue)         (in case of unsigned char pixels, default value is 128)
 ///
+/// iv.setOrigin(row , clm)            shift all produced points by (clm,row). Returns Self.
+///                                    img2curves sets it from getBegRow(img)/getBegClm(img),
+///                                    so for a view on a sub-region of an image (see Img.h)
+///                                    the curves come back in the whole-image coordinates.
+///
+/// iv.setTolerance(pixels)            simplify every produced curve (Douglas-Peucker) , a vertex
+///                                    is dropped only if it is within 'pixels' of the simplified
+///                                    curve. Returns Self. (default: 0 , every vertex is kept)
+///
 /// iv.img2curves ( const AnyImg& img , PolygonContainer* usrPgons)
 ///                               - fill container of containers of some kind of
 ///                                 'points' (the only request to 'points'-type:
@@ -533,6 +542,12 @@ public:
     Plins                           m_plins;
     int                             m_ext;     // extend rows by 0 or 1 pix on both sides
     int                             m_clrUnder;// relevant only in case with only 1 run in prv row
+    int                             m_orgRow;  // added to produced points only, internal
+    int                             m_orgClm;  // coordinates always start from 0
+    float                           m_tolerance; // of the simplification in moveto, 0 is none
+    std::vector<std::pair<float,float> >   m_dpPoints;  // scratch of simplify
+    std::vector<char>                      m_dpKeep;
+    std::vector<std::pair<size_t,size_t> > m_dpRanges;
     
 private:
     
@@ -551,6 +566,9 @@ private:
     , m_plins()
     , m_ext(-1)             // assume undef
     , m_clrUnder(0)
+    , m_orgRow(0)
+    , m_orgClm(0)
+    , m_tolerance(0)
     {
     }
     
@@ -563,6 +581,9 @@ public:
     , m_plins    ( rhs.m_plins     )
     , m_ext      ( rhs.m_ext       )
     , m_clrUnder ( rhs.m_clrUnder  )
+    , m_orgRow   ( rhs.m_orgRow    )
+    , m_orgClm   ( rhs.m_orgClm    )
+    , m_tolerance( rhs.m_tolerance )
     {
     }
     
@@ -570,6 +591,10 @@ public:
     
     void set1stRowNo(int firstRowNo)     { m_rowNo = firstRowNo-1;}
     
+    void setOrigin(int row, int clm)     { m_orgRow = row; m_orgClm = clm;}
+    
+    void setTolerance(float pixels)      { m_tolerance = pixels;}
+    
     ImgVectorizerBase<CoordType>& operator=(const ImgVectorizerBase<CoordType>& rhs)
     {
         if (this != &rhs) {
@@ -590,12 +615,64 @@ public:
         typedef typename Pcurve::value_type        PointXY;
         
         Coord extCorrection = is0x() ? Coord(0) : -Coord(m_ext);
+        Coord xOrg = extCorrection + Coord(m_orgClm);
+        Coord yOrg = Coord(m_orgRow);
         
-        for (typename Plin::const_iterator it = plin.begin(); !(it == plin.end()); ++it )
-            usrPcurve.insert(usrPcurve.end(), PointXY (it->first + extCorrection , it->second) );
+        bool keepAll = !(m_tolerance > 0) || plin.size() < 3;
+        if (!keepAll)
+            simplify(plin);
+        
+        size_t i = 0;
+        for (typename Plin::const_iterator it = plin.begin(); !(it == plin.end()); ++it, ++i )
+            if (keepAll || m_dpKeep[i])
+                usrPcurve.insert(usrPcurve.end(), PointXY (it->first + xOrg , it->second + yOrg) );
         plin.clear();
     }
     
+    // Douglas-Peucker : marks in m_dpKeep the vertices of plin that keep it within m_tolerance.
+    // the ends are always kept, a polygon is simplified as the polyline from its first vertex around
+    void simplify(const Plin& plin)
+    {
+        m_dpPoints.clear();
+        for (typename Plin::const_iterator it = plin.begin(); !(it == plin.end()); ++it )
+            m_dpPoints.push_back(std::make_pair(float(it->first), float(it->second)));
+        size_t n = m_dpPoints.size();
+        m_dpKeep.assign(n, 0);
+        m_dpKeep[0] = m_dpKeep[n-1] = 1;
+        
+        float tolerance2 = m_tolerance * m_tolerance;
+        m_dpRanges.clear();
+        m_dpRanges.push_back(std::make_pair(size_t(0), n-1));
+        while (m_dpRanges.size()) {
+            size_t beg = m_dpRanges.back().first;
+            size_t end = m_dpRanges.back().second;
+            m_dpRanges.pop_back();
+            if (end - beg < 2)
+                continue;
+            
+            float ax = m_dpPoints[beg].first, ay = m_dpPoints[beg].second;
+            float dx = m_dpPoints[end].first - ax, dy = m_dpPoints[end].second - ay;
+            float length2 = dx*dx + dy*dy;
+            float maxDist2 = 0;
+            size_t farthest = beg;
+            for (size_t i = beg+1; i != end; ++i) {
+                float px = m_dpPoints[i].first - ax, py = m_dpPoints[i].second - ay;
+                float t = length2 > 0 ? (px*dx + py*dy) / length2 : 0;
+                t = t < 0 ? 0 : (t > 1 ? 1 : t);        // distance to the segment, not to its line
+                px -= t*dx;
+                py -= t*dy;
+                float dist2 = px*px + py*py;
+                if (maxDist2 < dist2)
+                    maxDist2 = dist2, farthest = i;
+            }
+            if (maxDist2 > tolerance2) {
+                m_dpKeep[farthest] = 1;
+                m_dpRanges.push_back(std::make_pair(beg, farthest));
+                m_dpRanges.push_back(std::make_pair(farthest, end));
+            }
+        }
+    }
+    
     Coord sproutX(const Sprouts& sprouts, SproutsIterator itSprout)
     {
         return itSprout==sprouts.end() ? Coord(clmsExt()) : itSprout->thisVertexX();
@@ -847,6 +924,8 @@ public:
     
     Self& setImgWidth(int clms)           { Base::setImgWidth(clms);        return *this;}
     Self& set1stRowNo(int firstRowNo)     { Base::set1stRowNo(firstRowNo);  return *this;}
+    Self& setOrigin(int row, int clm)     { Base::setOrigin(row, clm);      return *this;}
+    Self& setTolerance(float pixels)      { Base::setTolerance(pixels);     return *this;}
     
     template < class AnyImg , class PolygonContainer >
     void img2curves ( const AnyImg& img, PolygonContainer* usrPgons )
@@ -861,6 +940,7 @@ public:
                      )
     {
         m_clms = getWidth (img);
+        setOrigin(getBegRow(img), getBegClm(img));
         delete[] m_runs;
         m_runs = 0;
         m_rowNo = -1;
@@ -1335,6 +1415,8 @@ public:
     
     Self& setImgWidth(int clms)           { Base::setImgWidth(clms);        return *this;}
     Self& set1stRowNo(int firstRowNo)     { Base::set1stRowNo(firstRowNo);  return *this;}
+    Self& setOrigin(int row, int clm)     { Base::setOrigin(row, clm);      return *this;}
+    Self& setTolerance(float pixels)      { Base::setTolerance(pixels);     return *this;}
     
     template<class Pix>
     Self& set0value(Pix v)                { m_zeroValue = PixVal(v); return *this;}
@@ -1352,6 +1434,7 @@ public:
                      )
     {
         m_clms = getWidth (img);
+        setOrigin(getBegRow(img), getBegClm(img));
         //m_rowNo = -1;
         
         typedef typename AnyImg::Pixel   Pixel;
@@ -0,0 +1,36 @@
+#ifndef abstract_detector_hpp
+#define abstract_detector_hpp
+
+#include <opencv2/core/mat.hpp>
+#include "image_algorithm.hpp"
+
+using namespace cv;
+
+namespace VehicleModule {
+    namespace Algorithm {
+
+        enum class DetectionMode
+        {
+            TARGET,     // the whole target must be in the frame (like 'find_bullseye')
+            DIRECTION   // part of the target is enough , the center may be outside the frame (like 'find_bullseye_direction')
+        };
+
+        /**
+         * a bullseye detection engine . engines are created by name through DetectorRegistry
+         */
+        class AbstractDetector
+        {
+        public:
+            virtual ~AbstractDetector() {}
+            /**
+             * find the target in the image
+             * @param  img input image (gray , BGR or YUYV) , may be a ROI of a bigger frame
+             * @param  out center and outer ring radius in pixels of the whole frame , and the confidence
+             * @return true if found target else false
+             */
+            virtual bool find(const Mat& img, BullseyeResult& out) = 0;
+        };
+    }
+}
+
+#endif /* abstract_detector_hpp */
@@ -0,0 +1,83 @@
+#include "altitude_estimator.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace VehicleModule::Algorithm;
+using namespace std;
+
+AltitudeEstimator::AltitudeEstimator(double ring_spacing, int num_rings, double field_of_view)
+: _ring_spacing(ring_spacing), _num_rings(num_rings), _field_of_view(field_of_view) {
+    reset();
+}
+
+bool AltitudeEstimator::try_get_vision_range(const BullseyeResult& result, int frame_width, double& range, double& sigma) const {
+    if (!result.found || result.radius <= 0 || frame_width <= 0 || !_telemetry_timestamp) {
+        return false;
+    }
+    double focal_length = frame_width / (2 * tan(0.5 * _field_of_view));
+    double meters_per_ring = _ring_spacing * focal_length / result.radius;
+    int ring = static_cast<int>(round(_altitude / meters_per_ring));
+    ring = max(1, min(ring, _num_rings));
+    range = ring * meters_per_ring;
+    sigma = range * ALTITUDE_RADIUS_SIGMA / result.radius / max(result.confidence, (double)ALTITUDE_MIN_CONFIDENCE);
+    return true;
+}
+
+void AltitudeEstimator::add_telemetry(double altitude, long long timestamp) {
+    if (!_telemetry_timestamp) {
+        _altitude = altitude;
+        _variance = ALTITUDE_TELEMETRY_SIGMA * ALTITUDE_TELEMETRY_SIGMA;
+        _timestamp = timestamp;
+    } else {
+        _update(altitude, ALTITUDE_TELEMETRY_SIGMA * ALTITUDE_TELEMETRY_SIGMA, timestamp);
+    }
+    _telemetry_timestamp = timestamp;
+}
+
+bool AltitudeEstimator::add_vision(const BullseyeResult& result, int frame_width, long long timestamp) {
+    double range, sigma;
+    if (!try_get_vision_range(result, frame_width, range, sigma)) {
+        return false;
+    }
+    // a wrong ring or a false detection
+    double gate = ALTITUDE_GATE * sqrt(_predicted_variance(timestamp) + sigma * sigma);
+    if (abs(range - _altitude) > gate) {
+        return false;
+    }
+    _update(range, sigma * sigma, timestamp);
+    return true;
+}
+
+bool AltitudeEstimator::needs_telemetry(long long timestamp) const {
+    return !_telemetry_timestamp || timestamp - _telemetry_timestamp >= ALTITUDE_TELEMETRY_PERIOD ||
+           get_sigma(timestamp) > ALTITUDE_MAX_SIGMA;
+}
+
+double AltitudeEstimator::get_altitude() const {
+    return _altitude;
+}
+
+double AltitudeEstimator::get_sigma(long long timestamp) const {
+    return sqrt(_predicted_variance(timestamp));
+}
+
+void AltitudeEstimator::reset() {
+    _altitude = 0;
+    _variance = 0;
+    _timestamp = 0;
+    _telemetry_timestamp = 0;
+}
+
+double AltitudeEstimator::_predicted_variance(long long timestamp) const {
+    // a frame may be captured a little before the last telemetry read
+    double seconds = max(0LL, timestamp - _timestamp) / 1000.0;
+    return _variance + ALTITUDE_DRIFT * ALTITUDE_DRIFT * seconds * seconds;
+}
+
+void AltitudeEstimator::_update(double measurement, double variance, long long timestamp) {
+    double predicted = _predicted_variance(timestamp);
+    double gain = predicted / (predicted + variance);
+    _altitude += gain * (measurement - _altitude);
+    _variance = (1 - gain) * predicted;
+    _timestamp = max(_timestamp, timestamp);
+}
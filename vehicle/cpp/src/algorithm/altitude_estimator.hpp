@@ -0,0 +1,86 @@
+#ifndef altitude_estimator_hpp
+#define altitude_estimator_hpp
+
+#include "image_algorithm.hpp"
+
+#define ALTITUDE_RADIUS_SIGMA 1.5           // pixels , error of the fitted ring radius of a perfect detection
+#define ALTITUDE_MIN_CONFIDENCE 0.25        // a weaker detection counts as this confident
+#define ALTITUDE_DRIFT 0.5                  // meters per second , how fast the altitude may change between updates
+#define ALTITUDE_TELEMETRY_SIGMA 0.1        // meters , error of the altitude of the vehicle
+#define ALTITUDE_MAX_SIGMA 0.3              // meters , telemetry is needed when the estimate is worse than this
+#define ALTITUDE_TELEMETRY_PERIOD 2000      // ms , telemetry is needed at least this often even if vision is good
+#define ALTITUDE_GATE 3                     // a vision range further than this many sigmas from the estimate is dropped
+
+/**
+ * estimates the altitude from the apparent size of the target and fuses it with the altitude of the vehicle
+ * the rings of the target have known radii (multiples of the ring spacing) so a ring of r pixels is at
+ * range = ring radius * focal length / r , where the focal length in pixels comes from the field of view.
+ * the detector doesn't tell which ring it measured , the ring that gives the range closest to the current
+ * estimate is taken so vision is used only after the first telemetry update.
+ * the range is along the optical axis , it is the altitude only while the vehicle is about level over the target
+ * (like the rangefinder) . the estimate is a 1D kalman filter : the variance grows with time (ALTITUDE_DRIFT)
+ * and every telemetry or vision measurement is weighted by its variance
+ */
+namespace VehicleModule {
+    namespace Algorithm {
+        class AltitudeEstimator {
+        public:
+            /**
+             * @param ring_spacing  meters between two rings of the target (the inner ring has this radius)
+             * @param num_rings     number of rings of the target
+             * @param field_of_view horizontal field of view of the camera in radians
+             */
+            AltitudeEstimator(double ring_spacing, int num_rings, double field_of_view);
+            /**
+             * range to the target from the outer ring radius of a detection
+             * @param  result      detection
+             * @param  frame_width width of the frame the detection is from
+             * @param  range       meters
+             * @param  sigma       meters , standard deviation of the range
+             * @return false if there is no target or no estimate yet to tell which ring it is
+             */
+            bool try_get_vision_range(const BullseyeResult& result, int frame_width, double& range, double& sigma) const;
+            /**
+             * @param altitude  meters , from the vehicle
+             * @param timestamp ms , when it was read
+             */
+            void add_telemetry(double altitude, long long timestamp);
+            /**
+             * @param  timestamp ms , capture time of the frame
+             * @return true if the detection was used
+             */
+            bool add_vision(const BullseyeResult& result, int frame_width, long long timestamp);
+            /**
+             * @param  timestamp ms , now
+             * @return true if the estimate should be refreshed from the vehicle
+             */
+            bool needs_telemetry(long long timestamp) const;
+            /**
+             * @return meters , the last estimate (0 before any telemetry)
+             */
+            double get_altitude() const;
+            /**
+             * @param  timestamp ms , now
+             * @return meters , standard deviation of the estimate at that time
+             */
+            double get_sigma(long long timestamp) const;
+            /**
+             * forget the estimate
+             */
+            void reset();
+        private:
+            double    _ring_spacing;
+            int       _num_rings;
+            double    _field_of_view;
+            double    _altitude;
+            double    _variance;
+            long long _timestamp;               // of the last update
+            long long _telemetry_timestamp;     // 0 if there was no telemetry yet
+
+            double _predicted_variance(long long timestamp) const;
+            void   _update(double measurement, double variance, long long timestamp);
+        };
+    }
+}
+
+#endif /* altitude_estimator_hpp */
@@ -0,0 +1,211 @@
+#include "concentric_circle_detector.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace VehicleModule::Algorithm;
+using namespace std;
+
+// |gx| + |gy| of a 3x3 sobel over uchar pixels
+#define CIRCLES_MAX_MAGNITUDE (2 * 4 * 255)
+
+ConcentricCircleDetector::ConcentricCircleDetector(DetectionMode mode)
+: _mode(mode), _rows(0), _cols(0) {}
+
+bool ConcentricCircleDetector::find(const Mat& img, BullseyeResult& out) {
+    out = BullseyeResult();
+    PixelFormat format;
+    if (!try_get_pixel_format(img, format)) {
+        return false;
+    }
+
+    int scale = max(1, (img.cols + CIRCLES_WORK_WIDTH - 1) / CIRCLES_WORK_WIDTH);
+    _rows = img.rows / scale;
+    _cols = img.cols / scale;
+    if (_rows < 2 * CIRCLES_MIN_RADIUS + 3 || _cols < 2 * CIRCLES_MIN_RADIUS + 3) {
+        return false;
+    }
+    _downscale(img, format, scale);
+
+    int threshold = _gradients();
+    if (threshold == 0) {
+        return false;
+    }
+
+    // in DIRECTION mode the center may be up to half a frame outside the frame
+    int margin = _mode == DetectionMode::DIRECTION ? max(_rows, _cols) / 2 : 0;
+    Point2f center;
+    if (!_vote(threshold, margin, center) || !_rings(center, threshold, out)) {
+        out = BullseyeResult();
+        return false;
+    }
+
+    // work pixel i covers the frame pixels [i*scale,(i+1)*scale)
+    Size whole_size;
+    Point origin;
+    img.locateROI(whole_size, origin);
+    out.center = Point(cvRound((center.x + 0.5) * scale - 0.5) + origin.x, cvRound((center.y + 0.5) * scale - 0.5) + origin.y);
+    out.radius *= scale;
+    return true;
+}
+
+void ConcentricCircleDetector::_downscale(const Mat& img, PixelFormat format, int scale) {
+    int cols = _cols * scale;
+    _row.resize(cols);
+    _sums.resize(_cols);
+    _luma.resize(_rows * _cols);
+    for (int i=0; i < _rows; i++) {
+        fill(_sums.begin(), _sums.end(), 0);
+        for (int k=0; k < scale; k++) {
+            luma_row(img.ptr<uchar>(i * scale + k), _row.data(), cols, format);
+            for (int j=0; j < cols; j++) {
+                _sums[j / scale] += _row[j];
+            }
+        }
+        uchar* luma = &_luma[i * _cols];
+        for (int j=0; j < _cols; j++) {
+            luma[j] = static_cast<uchar>(_sums[j] / (scale * scale));
+        }
+    }
+}
+
+int ConcentricCircleDetector::_gradients() {
+    int size = _rows * _cols;
+    _gx.assign(size, 0);
+    _gy.assign(size, 0);
+    _magnitude.assign(size, 0);
+
+    int histogram[CIRCLES_MAX_MAGNITUDE + 1] = {0};
+    for (int i=1; i < _rows - 1; i++) {
+        for (int j=1; j < _cols - 1; j++) {
+            int index = i * _cols + j;
+            const uchar* p = &_luma[index];
+            int gx = (p[1 - _cols] + 2 * p[1] + p[1 + _cols]) - (p[-1 - _cols] + 2 * p[-1] + p[-1 + _cols]);
+            int gy = (p[_cols - 1] + 2 * p[_cols] + p[_cols + 1]) - (p[-_cols - 1] + 2 * p[-_cols] + p[-_cols + 1]);
+            _gx[index] = gx;
+            _gy[index] = gy;
+            _magnitude[index] = abs(gx) + abs(gy);
+            histogram[_magnitude[index]]++;
+        }
+    }
+
+    // the weakest magnitude that is still in the strongest CIRCLES_EDGE_PERCENT
+    int edges = size * CIRCLES_EDGE_PERCENT / 100;
+    int threshold = CIRCLES_MAX_MAGNITUDE;
+    for (int count = histogram[threshold]; threshold > CIRCLES_MIN_GRADIENT && count < edges; count += histogram[--threshold]);
+    for (; threshold <= CIRCLES_MAX_MAGNITUDE && histogram[threshold] == 0; threshold++);
+    return threshold <= CIRCLES_MAX_MAGNITUDE ? threshold : 0;
+}
+
+bool ConcentricCircleDetector::_vote(int threshold, int margin, Point2f& center) {
+    int width = _cols + 2 * margin, height = _rows + 2 * margin;
+    int max_radius = _mode == DetectionMode::TARGET ? min(_rows, _cols) / 2 : max(_rows, _cols);
+    _votes.assign(width * height, 0);
+
+    for (int i=1; i < _rows - 1; i++) {
+        for (int j=1; j < _cols - 1; j++) {
+            int index = i * _cols + j;
+            if (_magnitude[index] < threshold) {
+                continue;
+            }
+            // the center is on the gradient line , on the dark side or the bright side
+            float norm = sqrt((float)_gx[index] * _gx[index] + (float)_gy[index] * _gy[index]);
+            for (int sign = -1; sign <= 1; sign += 2) {
+                float dx = sign * _gx[index] / norm, dy = sign * _gy[index] / norm;
+                float x = j + margin + 0.5f + CIRCLES_MIN_RADIUS * dx, y = i + margin + 0.5f + CIRCLES_MIN_RADIUS * dy;
+                for (int r = CIRCLES_MIN_RADIUS; r <= max_radius && x >= 0 && y >= 0 && x < width && y < height; r++, x += dx, y += dy) {
+                    _votes[(int)y * width + (int)x]++;
+                }
+            }
+        }
+    }
+
+    int best = 0, best_x = 0, best_y = 0;
+    for (int y=1; y < height - 1; y++) {
+        for (int x=1; x < width - 1; x++) {
+            const int* v = &_votes[y * width + x];
+            int votes = v[-width - 1] + v[-width] + v[-width + 1] + v[-1] + v[0] + v[1] + v[width - 1] + v[width] + v[width + 1];
+            if (votes > best) {
+                best = votes;
+                best_x = x;
+                best_y = y;
+            }
+        }
+    }
+    if (best == 0) {
+        return false;
+    }
+
+    float sum_x = 0, sum_y = 0;
+    for (int y = best_y - 1; y <= best_y + 1; y++) {
+        for (int x = best_x - 1; x <= best_x + 1; x++) {
+            sum_x += (float)_votes[y * width + x] * x;
+            sum_y += (float)_votes[y * width + x] * y;
+        }
+    }
+    center = Point2f(sum_x / best - margin, sum_y / best - margin);
+    return true;
+}
+
+bool ConcentricCircleDetector::_rings(const Point2f& center, int threshold, BullseyeResult& out) {
+    int max_radius = static_cast<int>(_mode == DetectionMode::TARGET ? min(_rows, _cols) / 2 : hypot(_rows, _cols));
+    vector<int> histogram(max_radius + 3, 0);
+    for (int i=1; i < _rows - 1; i++) {
+        for (int j=1; j < _cols - 1; j++) {
+            int index = i * _cols + j;
+            if (_magnitude[index] < threshold) {
+                continue;
+            }
+            float vx = j - center.x, vy = i - center.y;
+            float distance = sqrt(vx * vx + vy * vy);
+            if (distance < CIRCLES_MIN_RADIUS - 1 || distance > max_radius) {
+                continue;
+            }
+            float norm = sqrt((float)_gx[index] * _gx[index] + (float)_gy[index] * _gy[index]);
+            if (abs(_gx[index] * vx + _gy[index] * vy) < CIRCLES_RADIAL_COS * norm * distance) {
+                continue;
+            }
+            histogram[cvRound(distance)]++;
+        }
+    }
+
+    // a ring is a peak of the histogram , an edge is spread over about CIRCLES_EDGE_WIDTH pixels so the bins are summed in 3s
+    int rings = 0;
+    double total_support = 0;
+    for (int r = CIRCLES_MIN_RADIUS; r <= max_radius; r++) {
+        int support = histogram[r - 1] + histogram[r] + histogram[r + 1];
+        int previous = histogram[r - 2] + histogram[r - 1] + histogram[r];
+        int next = histogram[r] + histogram[r + 1] + histogram[r + 2];
+        if (support == 0 || support < previous || support <= next) {
+            continue;
+        }
+        double visible = _visible_part(center, r);
+        if (visible < (_mode == DetectionMode::TARGET ? 1.0 : CIRCLES_MIN_VISIBLE)) {
+            continue;
+        }
+        double ratio = support / (CIRCLES_EDGE_WIDTH * 2 * M_PI * r * visible);
+        if (ratio < CIRCLES_MIN_RING_SUPPORT) {
+            continue;
+        }
+        rings++;
+        total_support += min(ratio, 1.0);
+        out.radius = (double)(histogram[r - 1] * (r - 1) + histogram[r] * r + histogram[r + 1] * (r + 1)) / support;
+    }
+    if (rings < CIRCLES_MIN_RINGS) {
+        return false;
+    }
+    out.found = true;
+    out.confidence = total_support / rings;
+    return true;
+}
+
+double ConcentricCircleDetector::_visible_part(const Point2f& center, double radius) const {
+    int visible = 0;
+    for (int k=0; k < CIRCLES_VISIBILITY_SAMPLES; k++) {
+        double angle = 2 * M_PI * k / CIRCLES_VISIBILITY_SAMPLES;
+        double x = center.x + radius * cos(angle), y = center.y + radius * sin(angle);
+        if (x >= 0 && y >= 0 && x <= _cols - 1 && y <= _rows - 1) {
+            visible++;
+        }
+    }
+    return (double)visible / CIRCLES_VISIBILITY_SAMPLES;
+}
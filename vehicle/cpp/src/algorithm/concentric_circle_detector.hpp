@@ -0,0 +1,55 @@
+#ifndef concentric_circle_detector_hpp
+#define concentric_circle_detector_hpp
+
+#include <opencv2/core/mat.hpp>
+#include <opencv2/core/types.hpp>
+#include <vector>
+#include "abstract_detector.hpp"
+#include "luma_img.hpp"
+
+#define CIRCLES_WORK_WIDTH 160          // the image is box averaged down to about this width
+#define CIRCLES_MIN_RADIUS 3            // in work pixels
+#define CIRCLES_MIN_GRADIENT 64         // sobel magnitude , about a 16 gray levels step
+#define CIRCLES_EDGE_PERCENT 20         // only the strongest edges vote
+#define CIRCLES_RADIAL_COS 0.9          // an edge belongs to a ring if its gradient points at the center
+#define CIRCLES_EDGE_WIDTH 2            // a step between two rings is about 2 pixels of strong gradient
+#define CIRCLES_MIN_RING_SUPPORT 0.25   // part of the visible perimeter of a ring that must be an edge
+#define CIRCLES_MIN_VISIBLE 0.25        // part of a ring that must be inside the frame in DIRECTION mode
+#define CIRCLES_VISIBILITY_SAMPLES 64
+#define CIRCLES_MIN_RINGS 3
+
+using namespace cv;
+
+/**
+ * gradient voted concentric circle transform
+ * works on a small luminance copy of the frame . every strong edge votes for the points along its gradient
+ * line and since all the rings of a bullseye share the center , the center gets the votes of all the rings.
+ * the rings are then read from a histogram of the distances of the edges that point at the center.
+ * doesn't trace curves so it is cheap and doesn't care about broken or touching rings , but the
+ * center is only as accurate as the work resolution (PyramidDetector / TargetTracker refine it on a ROI)
+ */
+namespace VehicleModule {
+    namespace Algorithm {
+        class ConcentricCircleDetector : public AbstractDetector {
+        public:
+            ConcentricCircleDetector(DetectionMode mode);
+            bool find(const Mat& img, BullseyeResult& out);
+        private:
+            DetectionMode      _mode;
+            int                _rows, _cols;    // size of the work image
+            std::vector<uchar> _row;            // one row of the frame converted to luminance
+            std::vector<int>   _sums;
+            std::vector<uchar> _luma;           // the work image
+            std::vector<int>   _gx, _gy, _magnitude;
+            std::vector<int>   _votes;
+
+            void _downscale(const Mat& img, PixelFormat format, int scale);
+            int  _gradients();
+            bool _vote(int threshold, int margin, Point2f& center);
+            bool _rings(const Point2f& center, int threshold, BullseyeResult& out);
+            double _visible_part(const Point2f& center, double radius) const;
+        };
+    }
+}
+
+#endif /* concentric_circle_detector_hpp */
@@ -0,0 +1,116 @@
+#include "coverage_planner.hpp"
+#include "ground_projection.hpp"
+#include <cmath>
+#include <algorithm>
+
+using namespace VehicleModule::Algorithm;
+
+// centers of views of 'footprint' that cover [-radius , radius] , evenly spread at most 'step' apart
+static std::vector<double> spread(double radius, double footprint, double step) {
+    std::vector<double> positions;
+    double from = -radius + footprint / 2, to = radius - footprint / 2;
+    if (to <= from) {
+        positions.push_back(0);
+        return positions;
+    }
+    int count = (int) ceil((to - from) / step) + 1;
+    for (int i = 0; i < count; i++) {
+        positions.push_back(from + (to - from) * i / (count - 1));
+    }
+    return positions;
+}
+
+CoveragePlanner::CoveragePlanner(double field_of_view, int frame_width, int frame_height, double overlap)
+: _field_of_view(field_of_view), _frame_width(frame_width), _frame_height(frame_height), _overlap(overlap) {}
+
+void CoveragePlanner::get_footprint(double height, double& right, double& forward) const {
+    forward = meters_per_pixel(_frame_width, height, _field_of_view) * _frame_width;
+    right = meters_per_pixel(_frame_width, height, _field_of_view) * _frame_height;
+}
+
+std::vector<cv::Point2d> CoveragePlanner::plan(CoveragePattern pattern, double height, double radius, bool continuous) const {
+    double right, forward;
+    get_footprint(height, right, forward);
+    if (right <= 0 || forward <= 0) {
+        return std::vector<cv::Point2d>();
+    }
+    return pattern == CoveragePattern::SPIRAL ? _spiral(right, forward, radius, continuous)
+                                              : _lawnmower(right, forward, radius, continuous);
+}
+
+double CoveragePlanner::get_flight_length(const std::vector<cv::Point2d>& waypoints) {
+    double length = 0;
+    cv::Point2d position(0, 0);
+    for (const cv::Point2d& waypoint : waypoints) {
+        length += cv::norm(waypoint - position);
+        position = waypoint;
+    }
+    return length;
+}
+
+double CoveragePlanner::get_legacy_spiral_radius(double step, int turns) {
+    int moves_left_in_direction = 1;
+    int num_moves_in_direction = 1;
+    int j = 0, sign = 1;
+    double x = 0, y = step;
+    cv::Point2d position(0, 0), low(0, 0), high(0, 0);
+    while (j < turns) {
+        if (moves_left_in_direction-- == 0) {
+            num_moves_in_direction += 1 - (j % 2);
+            moves_left_in_direction = num_moves_in_direction;
+            sign = j++ % 2 == 0 ? sign : -sign;
+            double tmp = x;
+            x = std::abs(y) * sign;
+            y = std::abs(tmp) * sign;
+        }
+        position += cv::Point2d(x, y);
+        low = cv::Point2d(std::min(low.x, position.x), std::min(low.y, position.y));
+        high = cv::Point2d(std::max(high.x, position.x), std::max(high.y, position.y));
+    }
+    return (high.x - low.x + high.y - low.y) / 4;
+}
+
+std::vector<cv::Point2d> CoveragePlanner::_spiral(double right, double forward, double radius, bool continuous) const {
+    // forward , right , back , left like the old spiral , every second leg one step longer
+    static const cv::Point2d directions[] = {cv::Point2d(0, 1), cv::Point2d(1, 0), cv::Point2d(0, -1), cv::Point2d(-1, 0)};
+    cv::Point2d step(right * (1 - _overlap), forward * (1 - _overlap));
+    cv::Point2d position(0, 0), low(0, 0), high(0, 0);
+    std::vector<cv::Point2d> waypoints;
+    // once the square is covered the ring is finished , its last legs sweep the outer edges
+    bool covered = right / 2 >= radius && forward / 2 >= radius;
+    for (int leg = 0; !covered || leg % 4 != 0; leg++) {
+        cv::Point2d direction = directions[leg % 4];
+        int moves = leg / 2 + 1;
+        cv::Point2d move(direction.x * step.x, direction.y * step.y);
+        if (continuous) {
+            position += move * moves;
+            waypoints.push_back(position);
+        } else {
+            for (int i = 0; i < moves; i++) {
+                position += move;
+                waypoints.push_back(position);
+            }
+        }
+        low = cv::Point2d(std::min(low.x, position.x), std::min(low.y, position.y));
+        high = cv::Point2d(std::max(high.x, position.x), std::max(high.y, position.y));
+        covered = covered || (std::min(-low.x, high.x) + right / 2 >= radius && std::min(-low.y, high.y) + forward / 2 >= radius);
+    }
+    return waypoints;
+}
+
+std::vector<cv::Point2d> CoveragePlanner::_lawnmower(double right, double forward, double radius, bool continuous) const {
+    std::vector<double> lanes = spread(radius, right, right * (1 - _overlap));
+    std::vector<double> stops = spread(radius, forward, forward * (1 - _overlap));
+    std::vector<cv::Point2d> waypoints;
+    for (size_t lane = 0; lane < lanes.size(); lane++) {
+        // every second lane is flown back
+        for (size_t i = 0; i < stops.size(); i++) {
+            size_t stop = lane % 2 == 0 ? i : stops.size() - 1 - i;
+            if (continuous && i != 0 && i != stops.size() - 1) {
+                continue;
+            }
+            waypoints.push_back(cv::Point2d(lanes[lane], stops[stop]));
+        }
+    }
+    return waypoints;
+}
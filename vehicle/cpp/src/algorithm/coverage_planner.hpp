@@ -0,0 +1,72 @@
+#ifndef coverage_planner_hpp
+#define coverage_planner_hpp
+
+#include <vector>
+#include <opencv2/core/types.hpp>
+
+#define COVERAGE_OVERLAP 0.2            // part of the footprint that neighbouring views share , margin for the attitude and the position error
+
+/**
+ * the path that covers a square search area with the view of the camera
+ * the footprint on the ground is computed from the height and the field of view (see ground_projection) , the legs
+ * are a footprint less the overlap apart so nothing is seen twice more than needed and no gap is left
+ * the frame width is along the forward axis of the vehicle and the frame height along the right one , the footprint
+ * is a rectangle and the spacing is different on each axis
+ * all the positions are x meters right and y meters forward of the start , at the heading of the start
+ */
+namespace VehicleModule {
+    namespace Algorithm {
+        enum class CoveragePattern {
+            SPIRAL,     // from the start outwards , the first looks are where the target is most likely
+            LAWNMOWER   // parallel lanes along the forward axis from a corner , fewer turns for the same area
+        };
+
+        class CoveragePlanner {
+        public:
+            /**
+             * @param field_of_view horizontal field of view of the camera in radians
+             * @param frame_width   pixels
+             * @param frame_height  pixels
+             * @param overlap       part of the footprint that neighbouring views share
+             */
+            CoveragePlanner(double field_of_view, int frame_width, int frame_height, double overlap = COVERAGE_OVERLAP);
+            /**
+             * @param height  meters above the ground
+             * @param right   meters , the footprint across the right axis
+             * @param forward meters , the footprint across the forward axis
+             */
+            void get_footprint(double height, double& right, double& forward) const;
+            /**
+             * @param  pattern    of the path
+             * @param  height     meters above the ground , of the whole scan
+             * @param  radius     meters , half the side of the square around the start to cover
+             * @param  continuous true if frames are processed while flying , the legs then only have to be a footprint
+             *                    apart and only the turns are emitted . false for stop and stare , there is a waypoint
+             *                    every footprint along the legs too
+             * @return waypoints , the start itself is not in it
+             */
+            std::vector<cv::Point2d> plan(CoveragePattern pattern, double height, double radius, bool continuous) const;
+            /**
+             * @return meters , from the start through all the waypoints
+             */
+            static double get_flight_length(const std::vector<cv::Point2d>& waypoints);
+            /**
+             * the size of the area the old fixed spiral covered , to keep the meaning of its parameters
+             * @param  step  meters , of the old spiral
+             * @param  turns of the old spiral
+             * @return meters , half the side of the square it covered
+             */
+            static double get_legacy_spiral_radius(double step, int turns);
+        private:
+            double _field_of_view;
+            int    _frame_width;
+            int    _frame_height;
+            double _overlap;
+
+            std::vector<cv::Point2d> _spiral(double right, double forward, double radius, bool continuous) const;
+            std::vector<cv::Point2d> _lawnmower(double right, double forward, double radius, bool continuous) const;
+        };
+    }
+}
+
+#endif /* coverage_planner_hpp */
@@ -0,0 +1,103 @@
+#include "detection_accumulator.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace VehicleModule::Algorithm;
+using namespace std;
+
+DetectionAccumulator::DetectionAccumulator(double required_confidence, double gate)
+: _required_confidence(required_confidence), _gate(gate), _frames(0) {}
+
+void DetectionAccumulator::add(const BullseyeResult& result) {
+    add(Point2d(result.center.x, result.center.y), result.radius, result.found ? result.confidence : 0);
+}
+
+void DetectionAccumulator::add(const Point2d& center, double radius, double confidence) {
+    _frames++;
+    for (Cluster& cluster : _clusters) {
+        cluster.weight *= ACCUMULATOR_DECAY;
+    }
+    _clusters.erase(remove_if(_clusters.begin(), _clusters.end(), [](const Cluster& cluster) {
+        return cluster.weight < ACCUMULATOR_MIN_WEIGHT;
+    }), _clusters.end());
+
+    if (confidence <= 0) {
+        return;
+    }
+
+    Cluster* closest = nullptr;
+    double closest_distance = 0;
+    for (Cluster& cluster : _clusters) {
+        double distance = norm(cluster.center - center);
+        double gate = max(_gate, ACCUMULATOR_GATE_RADIUS_FACTOR * max(cluster.radius, radius));
+        if (distance <= gate && (!closest || distance < closest_distance)) {
+            closest = &cluster;
+            closest_distance = distance;
+        }
+    }
+
+    if (!closest) {
+        _clusters.push_back({center, radius, confidence});
+        return;
+    }
+    // the position follows the more confident detections
+    double weight = closest->weight + confidence;
+    closest->center = (closest->center * closest->weight + center * confidence) * (1 / weight);
+    closest->radius = (closest->radius * closest->weight + radius * confidence) / weight;
+    closest->weight = weight;
+}
+
+bool DetectionAccumulator::is_confirmed() const {
+    return get_evidence() >= _required_confidence;
+}
+
+bool DetectionAccumulator::is_hopeless(int frames_left) const {
+    if (_clusters.empty() && _frames >= ACCUMULATOR_MAX_EMPTY_FRAMES) {
+        return true;
+    }
+    // the most evidence possible is a perfect detection on every frame left
+    double decay = pow(ACCUMULATOR_DECAY, frames_left);
+    double best_possible = get_evidence() * decay + (1 - decay) / (1 - ACCUMULATOR_DECAY);
+    return best_possible < _required_confidence;
+}
+
+bool DetectionAccumulator::get_target(BullseyeResult& out) const {
+    const Cluster* best = _best();
+    if (!best) {
+        return false;
+    }
+    out.found = true;
+    out.center = Point(cvRound(best->center.x), cvRound(best->center.y));
+    out.radius = best->radius;
+    out.confidence = min(best->weight / _required_confidence, 1.0);
+    return true;
+}
+
+bool DetectionAccumulator::get_center(Point2d& out) const {
+    const Cluster* best = _best();
+    if (!best) {
+        return false;
+    }
+    out = best->center;
+    return true;
+}
+
+double DetectionAccumulator::get_evidence() const {
+    const Cluster* best = _best();
+    return best ? best->weight : 0;
+}
+
+void DetectionAccumulator::reset() {
+    _clusters.clear();
+    _frames = 0;
+}
+
+const DetectionAccumulator::Cluster* DetectionAccumulator::_best() const {
+    const Cluster* best = nullptr;
+    for (const Cluster& cluster : _clusters) {
+        if (!best || cluster.weight > best->weight) {
+            best = &cluster;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,86 @@
+#ifndef detection_accumulator_hpp
+#define detection_accumulator_hpp
+
+#include <vector>
+#include <opencv2/core/types.hpp>
+#include "image_algorithm.hpp"
+
+#define ACCUMULATOR_DECAY 0.85              // evidence kept from one frame to the next
+#define ACCUMULATOR_MIN_WEIGHT 0.05         // clusters with less evidence are forgotten
+#define ACCUMULATOR_GATE_PIXELS 20          // a detection joins a cluster if it is closer than this
+#define ACCUMULATOR_GATE_RADIUS_FACTOR 0.5  // or closer than this part of the target radius
+#define ACCUMULATOR_MAX_EMPTY_FRAMES 10     // frames without any evidence before giving up
+
+using namespace cv;
+
+/**
+ * collects the detections of consecutive frames taken from the same place and decides if there is a target
+ * detections are clustered by position (image pixels) and every cluster holds the sum of the confidence of its
+ * detections , decayed by ACCUMULATOR_DECAY every frame . a target is declared when a cluster has enough evidence
+ * so a clear target is confirmed after a few frames while hits that jump around or come once in a while never are
+ * the positions may be in any unit as long as the radius and the gate are in the same one : pixels for frames
+ * taken from the same place , meters on the ground for frames of a moving camera
+ */
+namespace VehicleModule {
+    namespace Algorithm {
+        class DetectionAccumulator {
+        public:
+            /**
+             * @param required_confidence evidence needed to declare a target , about the number of perfect detections in a row
+             * @param gate                a detection joins a cluster if it is closer than this (or than a part of the radius)
+             */
+            DetectionAccumulator(double required_confidence, double gate = ACCUMULATOR_GATE_PIXELS);
+            /**
+             * add the result of the next frame (found or not)
+             */
+            void add(const BullseyeResult& result);
+            /**
+             * add the next frame , a detection at a position that is not in pixels
+             * @param confidence 0 if nothing was found in the frame
+             */
+            void add(const Point2d& center, double radius, double confidence);
+            /**
+             * @return true if a target has enough evidence
+             */
+            bool is_confirmed() const;
+            /**
+             * @param  frames_left how many frames are left before the caller moves on
+             * @return true if no target can be confirmed in the frames left
+             */
+            bool is_hopeless(int frames_left) const;
+            /**
+             * @param  out the cluster with the most evidence , confidence is the evidence relative to the required one
+             * @return false if there is no cluster
+             */
+            bool get_target(BullseyeResult& out) const;
+            /**
+             * @param  out center of the cluster with the most evidence , not rounded
+             * @return false if there is no cluster
+             */
+            bool get_center(Point2d& out) const;
+            /**
+             * @return evidence of the best cluster
+             */
+            double get_evidence() const;
+            /**
+             * forget everything , should be called after the camera moved
+             */
+            void reset();
+        private:
+            struct Cluster {
+                Point2d center;
+                double  radius;
+                double  weight;
+            };
+
+            double               _required_confidence;
+            double               _gate;
+            std::vector<Cluster> _clusters;
+            int                  _frames;
+
+            const Cluster* _best() const;
+        };
+    }
+}
+
+#endif /* detection_accumulator_hpp */
@@ -0,0 +1,161 @@
+#include "detection_service.hpp"
+
+using namespace VehicleModule::Algorithm;
+using namespace VehicleModule::Video;
+
+// same clock as the frame timestamps of VideoProvider
+static long long now_in_milliseconds() {
+    struct timeval tp;
+    gettimeofday(&tp, NULL);
+    return tp.tv_sec * 1000 + tp.tv_usec / 1000;
+}
+
+DetectionService::DetectionService(const std::string& detector, DetectionMode mode)
+: _tracker(DetectorRegistry::get_instance().create(detector, mode)), _prefilter(mode), _use_prefilter(mode == DetectionMode::TARGET), _running(false), _reset_timestamp(0), _reset_requested(false), _next_listener_id(0) {}
+
+DetectionService::~DetectionService() {
+    stop();
+}
+
+void DetectionService::start() {
+    std::lock_guard<std::mutex> lk(_owner_lock);
+    if (_running.load()) {
+        return;
+    }
+    _running.store(true);
+    _thread = std::thread(&DetectionService::_run, this);
+}
+
+void DetectionService::stop() {
+    std::lock_guard<std::mutex> lk(_owner_lock);
+    _running.store(false);
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+    // wake the waiters so they don't sleep till the timeout
+    std::lock_guard<std::mutex> result_lk(_result_lock);
+    _new_result_cv.notify_all();
+}
+
+bool DetectionService::is_running() const {
+    return _running.load();
+}
+
+void DetectionService::reset() {
+    std::lock_guard<std::mutex> lk(_result_lock);
+    _reset_timestamp = now_in_milliseconds();
+    _reset_requested = true;
+    _latest.result = BullseyeResult();
+}
+
+bool DetectionService::get_latest(Detection& out) {
+    std::lock_guard<std::mutex> lk(_result_lock);
+    out = _latest;
+    return _latest.sequence != 0;
+}
+
+bool DetectionService::wait_for_next(long long sequence, Detection& out, int timeout_ms) {
+    std::unique_lock<std::mutex> lk(_result_lock);
+    bool got_result = _new_result_cv.wait_for(lk, std::chrono::milliseconds(timeout_ms), [this, sequence]() {
+        return _latest.sequence > sequence || !_running.load();
+    }) && _latest.sequence > sequence;
+    out = _latest;
+    return got_result;
+}
+
+void DetectionService::_run() {
+    VideoProvider& video_provider = VideoProvider::get_instance();
+    cv::Mat frame;
+    long long last_sequence = 0;
+    BullseyeResult last_result;
+    int reused_frames = 0;
+    _change_detector.reset();
+    while (_running.load()) {
+        Detection detection;
+        if (!video_provider.get_frame(frame, VideoProvider::Channel::DEFAULT, detection.timestamp, detection.sequence)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(DETECTION_SERVICE_NO_CAMERA_SLEEP));
+            continue;
+        }
+        if (detection.sequence == last_sequence) {
+            // already processed this frame
+            video_provider.wait_to_next_frame();
+            continue;
+        }
+        last_sequence = detection.sequence;
+
+        bool reset_requested;
+        {
+            std::lock_guard<std::mutex> lk(_result_lock);
+            reset_requested = _reset_requested;
+            _reset_requested = false;
+        }
+        if (reset_requested) {
+            _tracker.reset();
+            _change_detector.reset();
+        }
+
+        // after a reset there is no reference to compare to , the frame becomes the reference
+        bool unchanged = _is_unchanged(frame, last_result);
+        if (unchanged && reused_frames < DETECTION_SERVICE_MAX_REUSED_FRAMES) {
+            detection.result = last_result;
+            reused_frames++;
+        } else {
+            if (_use_prefilter && !_tracker.is_tracking() && !_prefilter.is_promising(frame)) {
+                // the tracker would search the whole frame for nothing
+                detection.result = BullseyeResult();
+            } else {
+                _tracker.find(frame, detection.timestamp, detection.result);
+            }
+            _change_detector.accept();
+            last_result = detection.result;
+            reused_frames = 0;
+        }
+        // joined after the detection , by then the snapshot after the capture has usually arrived
+        detection.has_telemetry = video_provider.get_frame_telemetry(detection.timestamp, detection.telemetry);
+        _publish(detection);
+    }
+}
+
+bool DetectionService::_is_unchanged(const Mat& frame, const BullseyeResult& last_result) {
+    if (!_change_detector.compare(frame)) {
+        return false;
+    }
+    if (!last_result.found) {
+        return !_change_detector.any_changed();
+    }
+    int margin = static_cast<int>(last_result.radius * DETECTION_SERVICE_CHANGE_MARGIN) + CHANGE_TILE_SIZE;
+    Rect target(last_result.center.x - margin, last_result.center.y - margin, 2 * margin, 2 * margin);
+    return !_change_detector.is_changed(target);
+}
+
+void DetectionService::_publish(const Detection& detection) {
+    {
+        std::lock_guard<std::mutex> lk(_result_lock);
+        if (detection.timestamp < _reset_timestamp) {
+            // the frame is from before the reset (reset was called while it was waiting or processed)
+            return;
+        }
+        _latest = detection;
+        _new_result_cv.notify_all();
+    }
+    std::lock_guard<std::mutex> lk(_listener_lock);
+    for (const std::pair<int, Listener>& listener : _listeners) {
+        listener.second(detection);
+    }
+}
+
+int DetectionService::add_listener(const Listener& listener) {
+    std::lock_guard<std::mutex> lk(_listener_lock);
+    _listeners.push_back(std::make_pair(_next_listener_id, listener));
+    return _next_listener_id++;
+}
+
+void DetectionService::remove_listener(int id) {
+    std::lock_guard<std::mutex> lk(_listener_lock);
+    for (auto itr = _listeners.begin(); itr != _listeners.end(); ++itr) {
+        if (itr->first == id) {
+            _listeners.erase(itr);
+            return;
+        }
+    }
+}
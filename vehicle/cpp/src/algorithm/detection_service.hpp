@@ -0,0 +1,125 @@
+#ifndef detection_service_hpp
+#define detection_service_hpp
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <sys/time.h>
+#include <opencv2/core/mat.hpp>
+#include "abstract_detector.hpp"
+#include "detector_registry.hpp"
+#include "target_tracker.hpp"
+#include "tile_change_detector.hpp"
+#include "ring_prefilter.hpp"
+#include "../video/video_provider.hpp"
+
+#define DETECTION_SERVICE_WAIT_TIMEOUT 500      // ms , about 15 frames
+#define DETECTION_SERVICE_NO_CAMERA_SLEEP 100   // ms , how long to wait before asking again when the camera isn't running
+#define DETECTION_SERVICE_MAX_REUSED_FRAMES 15  // the detector runs at least once a second (at 15 fps) even if nothing changed
+#define DETECTION_SERVICE_CHANGE_MARGIN 1.5     // part of the target radius around the target that must not change to reuse a result
+
+/**
+ * runs the detector in the background on every new frame of the VideoProvider
+ * detection doesn't wait for the mission anymore , while the mission talks to the vehicle (goto_xy etc.) the
+ * service keeps tracking the target and the mission just reads the latest result or waits for the next one.
+ * the frames are tracked with TargetTracker so most frames cost only a search window around the prediction
+ * when the detector is slower than the camera frames are skipped (the sequence tells how many)
+ * while hovering most frames are the same as the last one that was detected , such frames are compared by
+ * TileChangeDetector and get the last result without running the detector : when no tile changed , or when
+ * a target was found and nothing changed around it (a change elsewhere can't move the rings)
+ * in TARGET mode a full frame search runs only if RingPrefilter finds concentric structure in the frame , so the
+ * empty frames of a search cost a fraction of the detector (in DIRECTION mode a ring cut by the border looks too
+ * much like clutter for the prefilter to reject much)
+ */
+namespace VehicleModule {
+    namespace Algorithm {
+
+        struct Detection {
+            long long         sequence;         // frame sequence from VideoProvider , 0 if no frame was processed yet
+            long long         timestamp;        // capture time of the frame in milliseconds
+            BullseyeResult    result;
+            bool              has_telemetry;
+            Common::Telemetry telemetry;        // the vehicle at the capture time , valid if has_telemetry
+
+            Detection() : sequence(0), timestamp(0), has_telemetry(false) {}
+        };
+
+        class DetectionService {
+        public:
+            typedef std::function<void(const Detection&)> Listener;
+
+            /**
+             * @param detector name of the detection engine (see DetectorRegistry)
+             * @param mode     what the engine is looking for
+             */
+            DetectionService(const std::string& detector, DetectionMode mode);
+            ~DetectionService();
+            /**
+             * start the detection thread , does nothing if already started
+             */
+            void start();
+            /**
+             * stop the detection thread and wait for it to exit
+             */
+            void stop();
+            bool is_running() const;
+            /**
+             * drop the current track and every result of a frame that was captured before this call
+             * should be called after the vehicle moved in a way the motion model doesn't know about
+             */
+            void reset();
+            /**
+             * @param  out the result of the newest processed frame
+             * @return false if no frame was processed yet
+             */
+            bool get_latest(Detection& out);
+            /**
+             * suspend the current thread till a frame newer than 'sequence' is processed
+             * @param  sequence   sequence of the last result the caller saw (0 for any result)
+             * @param  out        the newest result
+             * @param  timeout_ms how long to wait
+             * @return false on timeout
+             */
+            bool wait_for_next(long long sequence, Detection& out, int timeout_ms = DETECTION_SERVICE_WAIT_TIMEOUT);
+            /**
+             * @param  listener called on the detection thread with every result , must be quick (post it somewhere)
+             * @return id for remove_listener
+             */
+            int add_listener(const Listener& listener);
+            /**
+             * the listener is not called anymore once this returns
+             */
+            void remove_listener(int id);
+
+            DetectionService(DetectionService const&) = delete;
+            void operator=(DetectionService const&) = delete;
+        private:
+            TargetTracker           _tracker;
+            RingPrefilter           _prefilter;
+            bool                    _use_prefilter;
+            std::thread             _thread;
+            std::atomic_bool        _running;
+            std::mutex              _owner_lock;        // serializes start / stop
+            std::mutex              _result_lock;
+            std::condition_variable _new_result_cv;
+            Detection               _latest;
+            TileChangeDetector      _change_detector;   // used only by the detection thread
+            long long               _reset_timestamp;   // results of frames captured before it are dropped
+            bool                    _reset_requested;
+            std::mutex              _listener_lock;     // held while the listeners are called
+            std::vector<std::pair<int, Listener> > _listeners;
+            int                     _next_listener_id;
+
+            void _run();
+            void _publish(const Detection& detection);
+            bool _is_unchanged(const Mat& frame, const BullseyeResult& last_result);
+        };
+    }
+}
+
+#endif /* detection_service_hpp */
@@ -0,0 +1,48 @@
+#include "detector_registry.hpp"
+#include "vectorizer_detector.hpp"
+#include "concentric_circle_detector.hpp"
+
+using namespace VehicleModule::Algorithm;
+
+static std::shared_ptr<AbstractDetector> create_vectorizer_detector(DetectionMode mode) {
+    return std::make_shared<VectorizerDetector>(mode);
+}
+
+static std::shared_ptr<AbstractDetector> create_exact_vectorizer_detector(DetectionMode mode) {
+    return std::make_shared<VectorizerDetector>(mode, 0);
+}
+
+static std::shared_ptr<AbstractDetector> create_concentric_circle_detector(DetectionMode mode) {
+    return std::make_shared<ConcentricCircleDetector>(mode);
+}
+
+DetectorRegistry::DetectorRegistry() {
+    _factories["vectorizer"] = &create_vectorizer_detector;
+    _factories["vectorizer_exact"] = &create_exact_vectorizer_detector;
+    _factories["concentric_circles"] = &create_concentric_circle_detector;
+}
+
+void DetectorRegistry::add(const string& name, Factory factory) {
+    _read_write_lock.write_lock();
+    bool found_detector = _factories.find(name) != _factories.end();
+    if (!found_detector) {
+        _factories[name] = factory;
+    }
+    _read_write_lock.write_unlock();
+
+    if (found_detector) {
+        throw DetectorRegistryException("Detector with name '" + name + "' already exists");
+    }
+}
+
+std::shared_ptr<AbstractDetector> DetectorRegistry::create(const string& name, DetectionMode mode) {
+    _read_write_lock.read_lock();
+    auto factory = _factories.find(name);
+    if (factory == _factories.end()) {
+        _read_write_lock.read_unlock();
+        throw DetectorRegistryException("Detector with name '" + name + "' doesn't exist");
+    }
+    Factory create_detector = factory->second;
+    _read_write_lock.read_unlock();
+    return create_detector(mode);
+}
@@ -0,0 +1,58 @@
+#ifndef detector_registry_hpp
+#define detector_registry_hpp
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "rw_lock.hpp"
+#include "../common/vehicle_module_exception.hpp"
+#include "abstract_detector.hpp"
+
+#define DEFAULT_DETECTOR "vectorizer"
+
+/**
+ * detection engines by name so the mission config can pick one at runtime
+ * built in engines:
+ *  "vectorizer"         - VectorizerDetector
+ *  "vectorizer_exact"   - VectorizerDetector without simplifying the traced curves
+ *  "concentric_circles" - ConcentricCircleDetector
+ */
+namespace VehicleModule {
+    namespace Algorithm {
+        class DetectorRegistry {
+        public:
+            typedef std::shared_ptr<AbstractDetector> (*Factory)(DetectionMode mode);
+
+            static DetectorRegistry& get_instance() {
+                static DetectorRegistry instance;
+                return instance;
+            }
+
+            /**
+             * register another engine
+             * @param name    name to be used in the mission config
+             * @param factory creates a new engine for the given mode
+             */
+            void add(const string& name, Factory factory);
+            /**
+             * @param  name name of the engine
+             * @param  mode what the engine is looking for
+             * @return a new engine , every user should have its own since engines keep scratch buffers
+             */
+            std::shared_ptr<AbstractDetector> create(const string& name, DetectionMode mode);
+
+            struct DetectorRegistryException : public Common::VehicleModuleException {
+                DetectorRegistryException(const string& message) : Common::VehicleModuleException(message) {}
+            };
+
+            DetectorRegistry(DetectorRegistry const&) = delete;
+            void operator=(DetectorRegistry const&)  = delete;
+        private:
+            unordered_map<string, Factory>  _factories;
+            ::Common::RWLock                _read_write_lock;
+            DetectorRegistry();
+        };
+    }
+}
+
+#endif /* detector_registry_hpp */
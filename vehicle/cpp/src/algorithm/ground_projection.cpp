@@ -0,0 +1,38 @@
+#include "ground_projection.hpp"
+#include <cmath>
+
+#define EARTH_RADIUS 6378137.0      // meters , WGS84 equator
+
+void VehicleModule::Algorithm::frame_to_body(const cv::Point& center, int frame_width, int frame_height, double height, double field_of_view,
+                                             double& right, double& forward) {
+    double scale = meters_per_pixel(frame_width, height, field_of_view);
+    right = -(center.y - frame_height / 2) * scale;
+    forward = -(center.x - frame_width / 2) * scale;
+}
+
+double VehicleModule::Algorithm::meters_per_pixel(int frame_width, double height, double field_of_view) {
+    return 2 * height * tan(0.5 * field_of_view) / frame_width;
+}
+
+void VehicleModule::Algorithm::body_to_ground(double right, double forward, double height, double roll, double pitch, double yaw,
+                                              double& north, double& east) {
+    double level_right = right, level_forward = forward;
+    if (height > 0) {
+        level_right = height * tan(atan2(right, height) + roll);
+        level_forward = height * tan(atan2(forward, height) - pitch);
+    }
+    north = level_forward * cos(yaw) - level_right * sin(yaw);
+    east = level_forward * sin(yaw) + level_right * cos(yaw);
+}
+
+void VehicleModule::Algorithm::ground_to_body(double north, double east, double yaw, double& right, double& forward) {
+    forward = north * cos(yaw) + east * sin(yaw);
+    right = -north * sin(yaw) + east * cos(yaw);
+}
+
+void VehicleModule::Algorithm::geodetic_to_local(double latitude, double longitude, double origin_latitude, double origin_longitude,
+                                                 double& north, double& east) {
+    double radians = M_PI / 180;
+    north = (latitude - origin_latitude) * radians * EARTH_RADIUS;
+    east = (longitude - origin_longitude) * radians * EARTH_RADIUS * cos(origin_latitude * radians);
+}
@@ -0,0 +1,59 @@
+#ifndef ground_projection_hpp
+#define ground_projection_hpp
+
+#include <cmath>
+#include <opencv2/core/types.hpp>
+
+#define CAMERA_FIELD_OF_VIEW (45 / (double) 360) * 2 * M_PI     // radians , horizontal
+
+/**
+ * from a point in a frame to the ground and back
+ * the camera looks down with the top of the frame to the right of the vehicle and the left of the frame to its front.
+ * 'body' is meters right and forward of the vehicle on the ground , as if it was level . 'ground' is meters north and
+ * east of some origin . a tilted camera doesn't look straight down : rolled right it looks to the right , pitched up
+ * it looks back , the attitude of the capture time undoes that
+ */
+namespace VehicleModule {
+    namespace Algorithm {
+        /**
+         * @param center        pixel in the frame
+         * @param frame_width   pixels
+         * @param frame_height  pixels
+         * @param height        meters , of the camera above the ground
+         * @param field_of_view horizontal field of view of the camera in radians
+         * @param right         meters , as if the camera looked straight down
+         * @param forward       meters
+         */
+        void frame_to_body(const cv::Point& center, int frame_width, int frame_height, double height, double field_of_view,
+                           double& right, double& forward);
+        /**
+         * @return meters on the ground per pixel of the frame , at the center
+         */
+        double meters_per_pixel(int frame_width, double height, double field_of_view);
+        /**
+         * @param right   meters , from frame_to_body
+         * @param forward meters
+         * @param height  meters
+         * @param roll    radians , of the vehicle when the frame was captured
+         * @param pitch   radians
+         * @param yaw     radians , heading from north
+         * @param north   meters from the vehicle
+         * @param east    meters from the vehicle
+         */
+        void body_to_ground(double right, double forward, double height, double roll, double pitch, double yaw,
+                            double& north, double& east);
+        /**
+         * the inverse of body_to_ground for a level vehicle
+         */
+        void ground_to_body(double north, double east, double yaw, double& right, double& forward);
+        /**
+         * flat earth around the origin , good for the few hundred meters of a mission
+         * @param north meters north of the origin
+         * @param east  meters east of the origin
+         */
+        void geodetic_to_local(double latitude, double longitude, double origin_latitude, double origin_longitude,
+                               double& north, double& east);
+    }
+}
+
+#endif /* ground_projection_hpp */
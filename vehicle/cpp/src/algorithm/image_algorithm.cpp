@@ -8,6 +8,7 @@
 
 #include "image_algorithm.hpp"
 #include "armadillo"
+#include <chrono>
 using namespace std;
 using namespace VehicleModule::Algorithm;
 
@@ -16,41 +17,6 @@ typedef Point2f Center;
 typedef double Rank;
 typedef std::pair<Center,Radius> Circle;
 
-static uchar get_median_pixel_value(const Mat& img) {
-    int bucket_size = 1 << sizeof(uchar)*8;
-    int bucket[bucket_size];
-    for (int i=0; i < bucket_size; i++) {
-        bucket[i] = 0;
-    }
-    for(int i=0; i < img.rows; i++) {
-        for (int j=0; j < img.cols; j++) {
-            bucket[img.at<uchar>(i, j)]++;
-        }
-    }
-
-    int low_count = img.rows*img.cols / 10;
-    int high_count = low_count;
-    for (int i=0; i < bucket_size; i++) {
-        int low_to_remove = min(low_count, bucket[i]);
-        int high_to_remvoe = min(high_count, bucket[bucket_size - i - 1]);
-        low_count -= low_to_remove;
-        high_count -= high_to_remvoe;
-        bucket[i] -= low_to_remove;
-        bucket[bucket_size - i - 1] -= high_to_remvoe;
-
-        if(low_to_remove == 0 && high_to_remvoe == 0){
-            break;
-        }
-    }
-
-    int count = 0, sum = 0;
-    for (int i=0; i < bucket_size; i++) {
-        count += bucket[i];
-        sum += bucket[i] * i;
-    }
-    return sum / count;
-}
-
 static Rank rank_polygon_as_circle(const vector<Point>& polygon) {
     double perimeter = arcLength(polygon, true);
     double area = contourArea(polygon);
@@ -131,7 +97,9 @@ static vector<Circle> get_suspects_from_polygons(const vector<vector<Point>>& po
     // TODO: set threshold
     vector<vector<Point>> matching_polygons = polygons;
     vector<Circle> circles;
-    matching_polygons.erase(remove_if(matching_polygons.begin(), matching_polygons.end(), [](vector<Point> polygon){ return polygon.size() < 10; }), matching_polygons.end());
+    matching_polygons.erase(remove_if(matching_polygons.begin(), matching_polygons.end(), [](const vector<Point>& polygon){
+        return polygon.size() < 3 || arcLength(polygon, true) < MIN_CURVE_LENGTH;
+    }), matching_polygons.end());
     if(!matching_polygons.size()){
         return circles;
     }
@@ -165,7 +133,9 @@ static vector<Circle> get_suspects_from_polylines(const vector<vector<Point>>& p
     vector<vector<Point>> matching_polylines = polylines;
     vector<pair<Circle, Rank>> suspects;
     vector<Circle> circles;
-    matching_polylines.erase(remove_if(matching_polylines.begin(), matching_polylines.end(), [](vector<Point> polyline){ return polyline.size() < 10; }), matching_polylines.end());
+    matching_polylines.erase(remove_if(matching_polylines.begin(), matching_polylines.end(), [](const vector<Point>& polyline){
+        return polyline.size() < MIN_POLYLINE_VERTICES || arcLength(polyline, false) < MIN_CURVE_LENGTH;
+    }), matching_polylines.end());
     if(!matching_polylines.size()){
         return circles;
     }
@@ -221,13 +191,24 @@ static vector<Circle> get_suspects_from_polylines(const vector<vector<Point>>& p
 }
 
 
-static bool target_center_from_circles(const vector<Circle> &circles , Point& target_center)
+// how well the centers of the rings agree compared to the size of the inner ring
+static double get_confidence(const vector<Circle>& closest_circles) {
+    vector<int> indexes;
+    for (int i=0; i < closest_circles.size(); i++) {
+        indexes.push_back(i);
+    }
+    double spread = get_diameter(closest_circles, indexes);
+    return max(0.0, 1 - spread / max(closest_circles[0].second, (double)CENTERS_MAX_SPREAD));
+}
+
+static bool target_center_from_circles(const vector<Circle> &circles , BullseyeResult& result)
 {
+    result = BullseyeResult();
     if (circles.size() < MIN_CENTERS) {
         return false;
     }
 
-    vector<Circle> closest_circles= get_closest_circles(circles, MIN_CENTERS, 30);
+    vector<Circle> closest_circles= get_closest_circles(circles, MIN_CENTERS, CENTERS_MAX_SPREAD);
     if(!closest_circles.size()){
         return false;
     }
@@ -242,21 +223,95 @@ static bool target_center_from_circles(const vector<Circle> &circles , Point& ta
         }
     }
 
-    target_center = static_cast<Point>(closest_circles[0].first);
+    result.found = true;
+    result.center = static_cast<Point>(closest_circles[0].first);
+    result.radius = closest_circles.back().second;
+    result.confidence = get_confidence(closest_circles);
     return true;
 
 }
 
+// measures the scope it lives in into the profile , does nothing without a profile
+class StageTimer {
+public:
+    StageTimer(BullseyeProfile* profile, BullseyeStage stage) : _profile(profile), _stage(static_cast<int>(stage)) {
+        if (_profile) {
+            _allocations = _profile->allocation_counter ? _profile->allocation_counter() : 0;
+            _start = chrono::steady_clock::now();
+        }
+    }
+    ~StageTimer() {
+        if (_profile) {
+            _profile->nanoseconds[_stage] += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - _start).count();
+            if (_profile->allocation_counter) {
+                _profile->allocations[_stage] += _profile->allocation_counter() - _allocations;
+            }
+        }
+    }
+private:
+    BullseyeProfile*                  _profile;
+    int                               _stage;
+    long long                         _allocations;
+    chrono::steady_clock::time_point  _start;
+};
+
+// polylines may be null , then every curve is closed along the image border and returned as a polygon
+static bool vectorize(const Mat& cv_img, vector<vector<Point> >* polylines, vector<vector<Point> >& polygons, double tolerance, BullseyeProfile* profile = nullptr) {
+    PixelFormat format;
+    if (!try_get_pixel_format(cv_img, format)) {
+        return false;
+    }
+
+    uchar threshold;
+    {
+        StageTimer timer(profile, BullseyeStage::THRESHOLD);
+        threshold = get_threshold(cv_img, THRESHOLD_METHOD);
+    }
+    StageTimer timer(profile, BullseyeStage::VECTORIZE);
+    LumaImg img(cv_img, format);
+    ImgVectorizer0x vectorizer(threshold);
+    vectorizer.setTolerance(tolerance);
+    if (polylines) {
+        vectorizer.img2curves(img, polylines, &polygons);
+    } else {
+        vectorizer.img2curves(img, &polygons);
+    }
+    if (profile) {
+        for (const vector<Point>& polygon : polygons) {
+            profile->points += polygon.size();
+        }
+        profile->curves += polygons.size();
+        if (polylines) {
+            for (const vector<Point>& polyline : *polylines) {
+                profile->points += polyline.size();
+            }
+            profile->curves += polylines->size();
+        }
+    }
+    return true;
+}
+
 bool VehicleModule::Algorithm::find_bullseye(const Mat& cv_img, Point& out) {
-    // Validate that img is uchar, single channel
-    if (cv_img.type() != CV_8UC1){
-       // throw ImageAlgorithmException("Image is not of type uchar 1 channel");
+    double radius;
+    return find_bullseye(cv_img, out, radius);
+}
+
+bool VehicleModule::Algorithm::find_bullseye(const Mat& cv_img, Point& out, double& radius) {
+    BullseyeResult result;
+    if (!find_bullseye(cv_img, result)) {
+        return false;
     }
+    out = result.center;
+    radius = result.radius;
+    return true;
+}
 
-    Img<uchar> img(cv_img.rows, cv_img.cols, cv_img.data);
-    ImgVectorizer0x vectorizer((uchar)0);//(get_median_pixel_value(cv_img));
+bool VehicleModule::Algorithm::find_bullseye(const Mat& cv_img, BullseyeResult& out, double tolerance) {
+    out = BullseyeResult();
     vector<vector<Point> > polygons;
-    vectorizer.img2curves(img, &polygons);
+    if (!vectorize(cv_img, nullptr, polygons, tolerance)) {
+        return false;
+    }
     // Get suspects circles
     vector<Circle> circles = get_suspects_from_polygons(polygons);
 
@@ -265,14 +320,27 @@ bool VehicleModule::Algorithm::find_bullseye(const Mat& cv_img, Point& out) {
 }
 
 bool VehicleModule::Algorithm::find_bullseye_direction(const Mat& cv_img, Point& out){
-    if (cv_img.type() != CV_8UC1){
-   //     throw ImageAlgorithmException("Image is not of type uchar 1 channel");
+    double radius;
+    return find_bullseye_direction(cv_img, out, radius);
+}
+
+bool VehicleModule::Algorithm::find_bullseye_direction(const Mat& cv_img, Point& out, double& radius){
+    BullseyeResult result;
+    if (!find_bullseye_direction(cv_img, result)) {
+        return false;
     }
-    Img<uchar> img(cv_img.rows, cv_img.cols, cv_img.data);
-    ImgVectorizer0x vectorizer((uchar)0);//(get_median_pixel_value(cv_img));
+    out = result.center;
+    radius = result.radius;
+    return true;
+}
+
+bool VehicleModule::Algorithm::find_bullseye_direction(const Mat& cv_img, BullseyeResult& out, double tolerance){
+    out = BullseyeResult();
     vector<vector<Point> > polygons;
     vector<vector<Point> > polylines;
-    vectorizer.img2curves(img, &polylines, &polygons);
+    if (!vectorize(cv_img, &polylines, polygons, tolerance)) {
+        return false;
+    }
     vector<Circle> circles = get_suspects_from_polygons(polygons);
     vector<Circle> polylines_best_circles = get_suspects_from_polylines(polylines);
     for(const Circle & circle : polylines_best_circles){
@@ -281,3 +349,31 @@ bool VehicleModule::Algorithm::find_bullseye_direction(const Mat& cv_img, Point&
     
     return target_center_from_circles(circles,out);
 }
+
+bool VehicleModule::Algorithm::find_bullseye_dual(const Mat& cv_img, BullseyeDetection& out, BullseyeProfile* profile, double tolerance) {
+    out = BullseyeDetection();
+    vector<vector<Point> > polygons;
+    vector<vector<Point> > polylines;
+    if (!vectorize(cv_img, &polylines, polygons, tolerance, profile)) {
+        return false;
+    }
+    // the polygon suspects are shared , only the polyline fitting is extra work for the direction result
+    vector<Circle> circles;
+    {
+        StageTimer timer(profile, BullseyeStage::CANDIDATE_SCORING);
+        circles = get_suspects_from_polygons(polygons);
+    }
+    vector<Circle> polylines_best_circles;
+    {
+        StageTimer timer(profile, BullseyeStage::CIRCLE_FITTING);
+        polylines_best_circles = get_suspects_from_polylines(polylines);
+    }
+    StageTimer timer(profile, BullseyeStage::CLUSTERING);
+    target_center_from_circles(circles, out.target);
+    for(const Circle & circle : polylines_best_circles){
+        circles.push_back(circle);
+    }
+    target_center_from_circles(circles, out.direction);
+
+    return out.target.found || out.direction.found;
+}
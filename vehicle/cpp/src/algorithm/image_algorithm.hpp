@@ -15,6 +15,8 @@
 #include <opencv2/imgproc.hpp>
 #include "Img.h"
 #include "ImgVectorizer.h"
+#include "threshold.hpp"
+#include "luma_img.hpp"
 #include <list>
 #include <algorithm>
 #include <armadillo>
@@ -26,13 +28,68 @@ using namespace cv;
 #define THRESHOLD_RADIUS_MIN 5
 #define THRESHOLD_RADIUS_MAX 10000000
 #define MIN_CENTERS 3
+#define CENTERS_MAX_SPREAD 30
+#define THRESHOLD_METHOD ThresholdMethod::OTSU
+#define VECTORIZER_TOLERANCE 0.7        // pixels , the traced curves are simplified to this (0 keeps every pixel step)
+#define MIN_CURVE_LENGTH 10             // pixels , shorter curves are noise
+#define MIN_POLYLINE_VERTICES 4         // any 3 vertices fit a circle exactly , the rank needs one more
 /**
  * we provide two built in image algorithms . you can add you own here
  *
+ * the input image may be a ROI of a bigger frame (img(rect)) or a buffer with padded rows , nothing is copied
+ * and the returned center is in the pixel coordinates of the whole frame.
+ * gray , BGR (the camera channels of VideoProvider) and YUYV images are accepted as is , the luminance is
+ * computed row by row while the image is vectorized (see LumaImg) . other image types are never found
  */
 namespace VehicleModule {
     namespace Algorithm {
 
+        struct BullseyeResult {
+            bool   found;
+            Point  center;          // center of target in pixels
+            double radius;          // radius in pixels of the outer ring that was used to find the center
+            double confidence;      // in [0,1] , 1 when the centers of the rings agree to the pixel
+
+            BullseyeResult() : found(false), radius(0), confidence(0) {}
+        };
+
+        struct BullseyeDetection {
+            BullseyeResult target;      // what 'find_bullseye' would return
+            BullseyeResult direction;   // what 'find_bullseye_direction' would return
+        };
+
+        enum class BullseyeStage
+        {
+            THRESHOLD,          // histogram and zero value of the vectorizer
+            VECTORIZE,          // img2curves
+            CANDIDATE_SCORING,  // ranking the polygons as circles
+            CIRCLE_FITTING,     // least squares circles through the polylines
+            CLUSTERING,         // picking the rings that share a center
+            COUNT
+        };
+
+        /**
+         * where the time of a single 'find_bullseye_dual' call went , for the offline benchmark
+         * every stage is added to the previous value so a profile can be summed over several calls
+         */
+        struct BullseyeProfile {
+            typedef long long (*Counter)();
+
+            long long nanoseconds[static_cast<int>(BullseyeStage::COUNT)];
+            long long allocations[static_cast<int>(BullseyeStage::COUNT)];
+            Counter   allocation_counter;   // total allocations so far , allocations are not counted if null
+            long long curves;               // traced by the vectorizer
+            long long points;               // in all the traced curves
+
+            BullseyeProfile(Counter counter = nullptr) : allocation_counter(counter) { clear(); }
+            void clear() {
+                std::fill(nanoseconds, nanoseconds + static_cast<int>(BullseyeStage::COUNT), 0);
+                std::fill(allocations, allocations + static_cast<int>(BullseyeStage::COUNT), 0);
+                curves = 0;
+                points = 0;
+            }
+        };
+
         /**
          * finds a bullseye target's center only if all the target in the frame
          * that means the target's center must be inside the frame unlike 'find_bullseye_direction'
@@ -41,6 +98,16 @@ namespace VehicleModule {
          * @return true if found target else false
          */
         bool find_bullseye(const Mat& img, Point& out);
+        /**
+         * same as 'find_bullseye' and also reports the apparent size of the target
+         * @param  radius radius in pixels of the outer ring that was used to find the center
+         */
+        bool find_bullseye(const Mat& img, Point& out, double& radius);
+        /**
+         * same as 'find_bullseye' and also reports the confidence of the result
+         * @param  tolerance in pixels of the simplification of the traced curves , 0 keeps every pixel step
+         */
+        bool find_bullseye(const Mat& img, BullseyeResult& out, double tolerance = VECTORIZER_TOLERANCE);
         /**
          * finds a bullseye target's center even if we have just part of the target in the frame
          * that means the target's center could be outside the frame
@@ -49,6 +116,27 @@ namespace VehicleModule {
          * @return true if found target else false
          */
         bool find_bullseye_direction(const Mat& img, Point& out);
+        /**
+         * same as 'find_bullseye_direction' and also reports the apparent size of the target
+         * @param  radius radius in pixels of the outer ring that was used to find the center
+         */
+        bool find_bullseye_direction(const Mat& img, Point& out, double& radius);
+        /**
+         * same as 'find_bullseye_direction' and also reports the confidence of the result
+         * @param  tolerance in pixels of the simplification of the traced curves , 0 keeps every pixel step
+         */
+        bool find_bullseye_direction(const Mat& img, BullseyeResult& out, double tolerance = VECTORIZER_TOLERANCE);
+        /**
+         * runs both 'find_bullseye' and 'find_bullseye_direction' over a single vectorization of the image
+         * the target result uses only the closed curves so a target cut by the frame border is left to the direction result
+         * @param  img  input image
+         * @param  out     both results with their confidence
+         * @param  profile   if not null the time and allocations of every stage are added to it
+         * @param  tolerance in pixels of the simplification of the traced curves , 0 keeps every pixel step
+         * @return true if any of the results found a target
+         */
+        bool find_bullseye_dual(const Mat& img, BullseyeDetection& out, BullseyeProfile* profile = nullptr,
+                                double tolerance = VECTORIZER_TOLERANCE);
     }
 }
 
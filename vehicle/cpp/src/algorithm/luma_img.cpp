@@ -0,0 +1,136 @@
+#include "luma_img.hpp"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define LUMA_NEON
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#define LUMA_SSSE3
+#define LUMA_SSE2
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define LUMA_SSE2
+#endif
+
+using namespace VehicleModule::Algorithm;
+
+bool VehicleModule::Algorithm::try_get_pixel_format(const Mat& img, PixelFormat& format) {
+    switch (img.type()) {
+        case CV_8UC1:
+            format = PixelFormat::GRAY;
+            return true;
+        case CV_8UC3:
+            format = PixelFormat::BGR;
+            return true;
+        case CV_8UC2:
+            format = PixelFormat::YUYV;
+            return true;
+        default:
+            return false;
+    }
+}
+
+// each returns the number of pixels it converted , the caller finishes the tail one pixel at a time
+static int bgr_row_simd(const uchar* src, uchar* dst, int cols) {
+    int i = 0;
+#if defined(LUMA_NEON)
+    const uint8x8_t weight_b = vdup_n_u8(LUMA_WEIGHT_B);
+    const uint8x8_t weight_g = vdup_n_u8(LUMA_WEIGHT_G);
+    const uint8x8_t weight_r = vdup_n_u8(LUMA_WEIGHT_R);
+    for (; i + 16 <= cols; i += 16) {
+        uint8x16x3_t bgr = vld3q_u8(src + 3 * i);
+        uint16x8_t low = vmull_u8(vget_low_u8(bgr.val[0]), weight_b);
+        low = vmlal_u8(low, vget_low_u8(bgr.val[1]), weight_g);
+        low = vmlal_u8(low, vget_low_u8(bgr.val[2]), weight_r);
+        uint16x8_t high = vmull_u8(vget_high_u8(bgr.val[0]), weight_b);
+        high = vmlal_u8(high, vget_high_u8(bgr.val[1]), weight_g);
+        high = vmlal_u8(high, vget_high_u8(bgr.val[2]), weight_r);
+        vst1q_u8(dst + i, vcombine_u8(vrshrn_n_u16(low, 8), vrshrn_n_u16(high, 8)));
+    }
+#elif defined(LUMA_SSSE3)
+    // gathers the b , g and r bytes of 16 pixels (48 bytes in 3 registers) into 3 registers
+    const __m128i b0 = _mm_setr_epi8( 0, 3, 6, 9,12,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1);
+    const __m128i b1 = _mm_setr_epi8(-1,-1,-1,-1,-1,-1, 2, 5, 8,11,14,-1,-1,-1,-1,-1);
+    const __m128i b2 = _mm_setr_epi8(-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, 1, 4, 7,10,13);
+    const __m128i g0 = _mm_setr_epi8( 1, 4, 7,10,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1);
+    const __m128i g1 = _mm_setr_epi8(-1,-1,-1,-1,-1, 0, 3, 6, 9,12,15,-1,-1,-1,-1,-1);
+    const __m128i g2 = _mm_setr_epi8(-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, 2, 5, 8,11,14);
+    const __m128i r0 = _mm_setr_epi8( 2, 5, 8,11,14,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1);
+    const __m128i r1 = _mm_setr_epi8(-1,-1,-1,-1,-1, 1, 4, 7,10,13,-1,-1,-1,-1,-1,-1);
+    const __m128i r2 = _mm_setr_epi8(-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, 0, 3, 6, 9,12,15);
+    const __m128i weight_b = _mm_set1_epi16(LUMA_WEIGHT_B);
+    const __m128i weight_g = _mm_set1_epi16(LUMA_WEIGHT_G);
+    const __m128i weight_r = _mm_set1_epi16(LUMA_WEIGHT_R);
+    const __m128i half = _mm_set1_epi16(128);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= cols; i += 16) {
+        const __m128i* p = reinterpret_cast<const __m128i*>(src + 3 * i);
+        __m128i a = _mm_loadu_si128(p), b = _mm_loadu_si128(p + 1), c = _mm_loadu_si128(p + 2);
+        __m128i blue  = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, b0), _mm_shuffle_epi8(b, b1)), _mm_shuffle_epi8(c, b2));
+        __m128i green = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, g0), _mm_shuffle_epi8(b, g1)), _mm_shuffle_epi8(c, g2));
+        __m128i red   = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, r0), _mm_shuffle_epi8(b, r1)), _mm_shuffle_epi8(c, r2));
+        // 255 * 256 + 128 still fits in an unsigned 16 bit lane
+        __m128i low = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(blue, zero), weight_b),
+                                                  _mm_mullo_epi16(_mm_unpacklo_epi8(green, zero), weight_g)),
+                                    _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(red, zero), weight_r), half));
+        __m128i high = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(blue, zero), weight_b),
+                                                   _mm_mullo_epi16(_mm_unpackhi_epi8(green, zero), weight_g)),
+                                     _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(red, zero), weight_r), half));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(_mm_srli_epi16(low, 8), _mm_srli_epi16(high, 8)));
+    }
+#endif
+    return i;
+}
+
+static int yuyv_row_simd(const uchar* src, uchar* dst, int cols) {
+    int i = 0;
+#if defined(LUMA_NEON)
+    for (; i + 16 <= cols; i += 16) {
+        vst1q_u8(dst + i, vld2q_u8(src + 2 * i).val[0]);
+    }
+#elif defined(LUMA_SSE2)
+    const __m128i luma_mask = _mm_set1_epi16(0x00ff);
+    for (; i + 16 <= cols; i += 16) {
+        const __m128i* p = reinterpret_cast<const __m128i*>(src + 2 * i);
+        __m128i low = _mm_and_si128(_mm_loadu_si128(p), luma_mask);
+        __m128i high = _mm_and_si128(_mm_loadu_si128(p + 1), luma_mask);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(low, high));
+    }
+#endif
+    return i;
+}
+
+void VehicleModule::Algorithm::luma_row(const uchar* src, uchar* dst, int cols, PixelFormat format) {
+    int i = 0;
+    switch (format) {
+        case PixelFormat::BGR:
+            i = bgr_row_simd(src, dst, cols);
+            break;
+        case PixelFormat::YUYV:
+            i = yuyv_row_simd(src, dst, cols);
+            break;
+        default:
+            break;
+    }
+    for (; i < cols; i++) {
+        dst[i] = luma_pixel(src, i, format);
+    }
+}
+
+LumaImg::LumaImg(const Mat& img, PixelFormat format)
+: _img(img), _format(format) {
+    Size whole_size;
+    _img.locateROI(whole_size, _origin);
+    if (_format != PixelFormat::GRAY) {
+        _row.resize(_img.cols);
+    }
+}
+
+LumaImg::ConstPixelPtr LumaImg::operator[](int row) const {
+    const uchar* src = _img.ptr<uchar>(row);
+    if (_format == PixelFormat::GRAY) {
+        return src;
+    }
+    luma_row(src, _row.data(), _img.cols, _format);
+    return _row.data();
+}
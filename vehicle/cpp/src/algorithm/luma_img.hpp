@@ -0,0 +1,95 @@
+#ifndef luma_img_hpp
+#define luma_img_hpp
+
+#include <opencv2/core/mat.hpp>
+#include <vector>
+#include "Img.h"
+
+// BT.601 weights in 1/256 units (same as cv::cvtColor BGR2GRAY) , they sum to 256
+#define LUMA_WEIGHT_B 29
+#define LUMA_WEIGHT_G 150
+#define LUMA_WEIGHT_R 77
+
+using namespace cv;
+
+/**
+ * luminance of the camera frame without a separate color conversion pass.
+ * the vectorizer reads the image one row at a time , so each row is converted into a single
+ * row buffer right before the vectorizer consumes it (the buffer stays in the cache and no full
+ * gray frame is ever allocated)
+ */
+namespace VehicleModule {
+    namespace Algorithm {
+
+        enum class PixelFormat
+        {
+            GRAY,   // CV_8UC1
+            BGR,    // CV_8UC3 , what the camera channels of VideoProvider hold
+            YUYV    // CV_8UC2 , packed 4:2:2 as it comes from the camera , channel 0 is the luminance
+        };
+
+        /**
+         * @param  img    input image
+         * @param  format output format of the image
+         * @return false if the image type is none of the supported formats
+         */
+        bool try_get_pixel_format(const Mat& img, PixelFormat& format);
+        /**
+         * converts one row to luminance
+         * uses NEON on arm and SSSE3/SSE2 on x86 when the compiler enables them
+         * @param src    first pixel of the row
+         * @param dst    output row of 'cols' bytes
+         * @param cols   number of pixels in the row
+         * @param format format of src
+         */
+        void luma_row(const uchar* src, uchar* dst, int cols, PixelFormat format);
+        /**
+         * luminance of a single pixel , for code that samples the image instead of reading whole rows
+         */
+        inline uchar luma_pixel(const uchar* row, int col, PixelFormat format) {
+            switch (format) {
+                case PixelFormat::BGR:
+                    row += 3 * col;
+                    return static_cast<uchar>((LUMA_WEIGHT_B * row[0] + LUMA_WEIGHT_G * row[1] + LUMA_WEIGHT_R * row[2] + 128) >> 8);
+                case PixelFormat::YUYV:
+                    return row[2 * col];
+                default:
+                    return row[col];
+            }
+        }
+
+        /**
+         * read only image of the luminance of a cv::Mat that can be passed to ImgVectorizer::img2curves
+         * img[r] converts row r and returns a pointer that is valid until the next img[r] call.
+         * gray images are not copied at all , the pointer is the row of the cv::Mat.
+         * the origin of a ROI (img(rect)) is kept so the vectorizer returns whole frame coordinates
+         */
+        class LumaImg : public ImgTypes<uchar> {
+        public:
+            /**
+             * @param img    input image , may be a non continuous sub region
+             * @param format format of img (see try_get_pixel_format)
+             */
+            LumaImg(const Mat& img, PixelFormat format);
+
+            ConstPixelPtr operator[](int row) const;
+
+            int getHeight() const { return _img.rows;}
+            int getWidth () const { return _img.cols;}
+            int getBegRow() const { return _origin.y;}
+            int getBegClm() const { return _origin.x;}
+        private:
+            Mat                        _img;
+            PixelFormat                _format;
+            Point                      _origin;
+            mutable std::vector<uchar> _row;
+        };
+
+        inline int getHeight(const LumaImg& img)  { return img.getHeight();}
+        inline int getWidth (const LumaImg& img)  { return img.getWidth();}
+        inline int getBegRow(const LumaImg& img)  { return img.getBegRow();}
+        inline int getBegClm(const LumaImg& img)  { return img.getBegClm();}
+    }
+}
+
+#endif /* luma_img_hpp */
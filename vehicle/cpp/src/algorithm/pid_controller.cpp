@@ -0,0 +1,39 @@
+#include "pid_controller.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace VehicleModule::Algorithm;
+
+PidController::PidController(double kp, double ki, double kd, double output_limit)
+: _kp(kp), _ki(ki), _kd(kd), _output_limit(output_limit) {
+    reset();
+}
+
+void PidController::reset() {
+    _started = false;
+    _last_time = _last_error = 0;
+    _integral = _derivative = 0;
+}
+
+double PidController::update(double error, double time) {
+    double dt = time - _last_time;
+    if (!_started || dt > PID_MAX_GAP) {
+        _started = true;
+        _integral = _derivative = 0;
+    } else if (dt > 0) {
+        double derivative = (error - _last_error) / dt;
+        _derivative += (derivative - _derivative) * dt / (PID_DERIVATIVE_FILTER + dt);
+        double integral = _integral + error * dt;
+        double output = _kp * error + _ki * integral + _kd * _derivative;
+        if (std::fabs(output) <= _output_limit || std::fabs(integral) < std::fabs(_integral)) {
+            _integral = integral;
+        }
+    }
+    _last_time = time;
+    _last_error = error;
+    return _clamp(_kp * error + _ki * _integral + _kd * _derivative);
+}
+
+double PidController::_clamp(double output) const {
+    return std::max(-_output_limit, std::min(_output_limit, output));
+}
@@ -0,0 +1,43 @@
+#ifndef pid_controller_hpp
+#define pid_controller_hpp
+
+#define PID_MAX_GAP 0.5                 // seconds , after a longer gap between updates the integral and derivative restart
+#define PID_DERIVATIVE_FILTER 0.1       // seconds , time constant of the low pass on the derivative
+
+/**
+ * PID of one axis over time
+ * the integral and the derivative are over the real time between updates , so the gains don't depend on how
+ * often the controller runs . the derivative is low passed (the error changes in steps , once per detection)
+ * and the integral doesn't grow while the output is saturated in the same direction (anti windup)
+ */
+namespace VehicleModule {
+    namespace Algorithm {
+        class PidController {
+        public:
+            /**
+             * @param kp           output per unit of error
+             * @param ki           output per unit of error times seconds
+             * @param kd           output per unit of error per second
+             * @param output_limit the output is clamped to +-output_limit
+             */
+            PidController(double kp, double ki, double kd, double output_limit);
+            /**
+             * @param  error current error
+             * @param  time  seconds on a steady clock
+             * @return the output
+             */
+            double update(double error, double time);
+            void reset();
+            double get_integral() const { return _integral; }
+        private:
+            double _kp, _ki, _kd, _output_limit;
+            bool   _started;
+            double _last_time, _last_error;
+            double _integral, _derivative;
+
+            double _clamp(double output) const;
+        };
+    }
+}
+
+#endif /* pid_controller_hpp */
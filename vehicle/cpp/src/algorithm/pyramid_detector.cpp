@@ -0,0 +1,86 @@
+#include "pyramid_detector.hpp"
+
+using namespace VehicleModule::Algorithm;
+
+PyramidDetector::PyramidDetector(Detector detector)
+: _detector(detector), _level(PYRAMID_DEFAULT_LEVEL), _misses(0) {}
+
+bool PyramidDetector::find(const Mat& img, Point& out) {
+    double radius;
+    return find(img, out, radius);
+}
+
+bool PyramidDetector::find(const Mat& img, Point& out, double& radius) {
+    BullseyeResult result;
+    if (!find(img, result)) {
+        return false;
+    }
+    out = result.center;
+    radius = result.radius;
+    return true;
+}
+
+bool PyramidDetector::find(const Mat& img, BullseyeResult& out) {
+    int scale = 1 << _level;
+    if (scale == 1 || img.cols < scale * PYRAMID_MIN_ROI_SIZE || img.rows < scale * PYRAMID_MIN_ROI_SIZE) {
+        bool found = _detector->find(img, out);
+        _update_level(found ? out.radius : 0);
+        return found;
+    }
+
+    Mat coarse;
+    resize(img, coarse, Size(img.cols / scale, img.rows / scale), 0, 0, INTER_AREA);
+    if (!_detector->find(coarse, out)) {
+        _update_level(0);
+        return false;
+    }
+
+    // pixel (i,j) at the coarse level covers the full resolution pixels [i*scale,(i+1)*scale)
+    Point center(out.center.x * scale + scale / 2, out.center.y * scale + scale / 2);
+    double radius = out.radius * scale;
+
+    int half_size = static_cast<int>(radius * PYRAMID_ROI_MARGIN) + PYRAMID_ROI_PADDING;
+    Rect roi = Rect(center.x - half_size, center.y - half_size, 2 * half_size, 2 * half_size) & Rect(0, 0, img.cols, img.rows);
+    // the coarse center is off by up to scale / 2 pixels , only a full resolution fit is returned
+    BullseyeResult fine;
+    bool found = roi.width >= PYRAMID_MIN_ROI_SIZE && roi.height >= PYRAMID_MIN_ROI_SIZE
+                 ? _detector->find(img(roi), fine)
+                 : _detector->find(img, fine);
+    if (!found) {
+        out = BullseyeResult();
+        _update_level(0);
+        return false;
+    }
+    out = fine;
+    _update_level(out.radius);
+    return true;
+}
+
+void PyramidDetector::reset() {
+    _level = PYRAMID_DEFAULT_LEVEL;
+    _misses = 0;
+}
+
+int PyramidDetector::get_level() const {
+    return _level;
+}
+
+void PyramidDetector::_update_level(double radius) {
+    if (radius <= 0) {
+        // a target that got too small for its level is visible one level down , so that is tried once . after that
+        // the scene is probably empty , it stays at the cheap default level and full resolution is only probed
+        // once every PYRAMID_PROBE_MISSES frames
+        _misses++;
+        if (_misses == 1 && _level > 0) {
+            _level--;
+        } else {
+            _level = _misses % PYRAMID_PROBE_MISSES == 0 ? 0 : PYRAMID_DEFAULT_LEVEL;
+        }
+        return;
+    }
+    _misses = 0;
+    _level = 0;
+    while (_level < PYRAMID_MAX_LEVEL && radius / (2 << _level) >= PYRAMID_MIN_LEVEL_RADIUS) {
+        _level++;
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef pyramid_detector_hpp
+#define pyramid_detector_hpp
+
+#include <opencv2/core/mat.hpp>
+#include <opencv2/core/types.hpp>
+#include <opencv2/imgproc.hpp>
+#include <memory>
+#include "abstract_detector.hpp"
+
+#define PYRAMID_MAX_LEVEL 2
+#define PYRAMID_DEFAULT_LEVEL 1
+#define PYRAMID_MIN_LEVEL_RADIUS 20
+#define PYRAMID_ROI_MARGIN 1.5
+#define PYRAMID_ROI_PADDING 8
+#define PYRAMID_MIN_ROI_SIZE 16
+#define PYRAMID_PROBE_MISSES 8      // on an empty scene a full resolution frame is searched once every this many misses
+
+using namespace cv;
+
+/**
+ * coarse to fine detection
+ * the detector runs first on a downscaled copy of the frame (level 1 is half resolution , level 2 is quarter resolution)
+ * and then runs again at full resolution only inside a window around the coarse candidate.
+ * the level is picked from the apparent size of the target in the previous detection so the
+ * outer ring stays at least PYRAMID_MIN_LEVEL_RADIUS pixels wide at the coarse level.
+ * right after the target was lost the next frame is searched one level finer , after that the empty scene stays at
+ * PYRAMID_DEFAULT_LEVEL and only every PYRAMID_PROBE_MISSES-th frame is searched at full resolution (for a target
+ * too small for the coarse level)
+ * a coarse candidate that isn't confirmed at full resolution is a miss , the result is always a full resolution fit
+ */
+namespace VehicleModule {
+    namespace Algorithm {
+        class PyramidDetector {
+        public:
+            typedef std::shared_ptr<AbstractDetector> Detector;
+            /**
+             * @param detector engine to run at each level (see DetectorRegistry)
+             */
+            PyramidDetector(Detector detector);
+            /**
+             * find the target center in full resolution pixels
+             * @param  img input image , may be a ROI of a bigger frame
+             * @param  out center of target in pixels of the whole frame if we found one
+             * @return true if found target else false
+             */
+            bool find(const Mat& img, Point& out);
+            /**
+             * same as find and also reports the radius of the outer ring in full resolution pixels
+             */
+            bool find(const Mat& img, Point& out, double& radius);
+            /**
+             * same as find and also reports the confidence of the detection
+             */
+            bool find(const Mat& img, BullseyeResult& out);
+            /**
+             * forget the previous detection and go back to PYRAMID_DEFAULT_LEVEL
+             */
+            void reset();
+            /**
+             * @return the pyramid level that will be used for the next frame
+             */
+            int get_level() const;
+        private:
+            Detector _detector;
+            int      _level;
+            int      _misses;   // since the last detection
+
+            void _update_level(double radius);
+        };
+    }
+}
+
+#endif /* pyramid_detector_hpp */
@@ -0,0 +1,113 @@
+#include "ring_prefilter.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace VehicleModule::Algorithm;
+using namespace std;
+
+// |gx| + |gy| of central differences over uchar pixels
+#define PREFILTER_MAX_MAGNITUDE (2 * 255)
+// fixed point positions on the vote grid
+#define PREFILTER_FIXED_SHIFT 16
+
+RingPrefilter::RingPrefilter(DetectionMode mode)
+: _mode(mode), _rows(0), _cols(0), _last_votes(0) {}
+
+bool RingPrefilter::is_promising(const Mat& img) {
+    _last_votes = 0;
+    PixelFormat format;
+    if (!try_get_pixel_format(img, format)) {
+        return false;
+    }
+    int scale = max(1, (img.cols + PREFILTER_WORK_WIDTH - 1) / PREFILTER_WORK_WIDTH);
+    _rows = img.rows / scale;
+    _cols = img.cols / scale;
+    if (_rows < 2 * PREFILTER_MIN_RADIUS + 3 || _cols < 2 * PREFILTER_MIN_RADIUS + 3) {
+        // too small to tell , let the detector decide
+        return true;
+    }
+    _sample(img, format, scale);
+    _find_edges();
+
+    // votes are counted in 2x2 work pixel cells , in DIRECTION mode the center may be up to half a frame outside the frame
+    int margin = _mode == DetectionMode::DIRECTION ? max(_rows, _cols) / 4 : 0;
+    int width = (_cols + 1) / 2 + 2 * margin, height = (_rows + 1) / 2 + 2 * margin;
+    int steps = (_mode == DetectionMode::TARGET ? min(_rows, _cols) / 2 : max(_rows, _cols)) / 2;
+    _votes.assign(width * height, 0);
+    const int one = 1 << PREFILTER_FIXED_SHIFT;
+    for (size_t e = 0; e < _edges.size(); e += 3) {
+        int i = _edges[e] / _cols, j = _edges[e] % _cols;
+        float norm = sqrt((float)_edges[e + 1] * _edges[e + 1] + (float)_edges[e + 2] * _edges[e + 2]);
+        // one step is one cell (2 work pixels) along the gradient line , the center is on the dark side or the bright side
+        int dx = static_cast<int>(_edges[e + 1] / norm * one), dy = static_cast<int>(_edges[e + 2] / norm * one);
+        for (int sign = -1; sign <= 1; sign += 2) {
+            int x = static_cast<int>(((j + 0.5f) / 2 + margin) * one) + sign * dx * PREFILTER_MIN_RADIUS / 2;
+            int y = static_cast<int>(((i + 0.5f) / 2 + margin) * one) + sign * dy * PREFILTER_MIN_RADIUS / 2;
+            for (int step = PREFILTER_MIN_RADIUS / 2; step <= steps; step++, x += sign * dx, y += sign * dy) {
+                int cell_x = x >> PREFILTER_FIXED_SHIFT, cell_y = y >> PREFILTER_FIXED_SHIFT;
+                if (x < 0 || y < 0 || cell_x >= width || cell_y >= height) {
+                    break;
+                }
+                _votes[cell_y * width + cell_x]++;
+            }
+        }
+    }
+
+    for (int y=1; y < height - 1; y++) {
+        const int* v = &_votes[y * width];
+        for (int x=1; x < width - 1; x++) {
+            int votes = v[x - width - 1] + v[x - width] + v[x - width + 1] + v[x - 1] + v[x] + v[x + 1] + v[x + width - 1] + v[x + width] + v[x + width + 1];
+            _last_votes = max(_last_votes, votes);
+        }
+    }
+    return _last_votes >= (_mode == DetectionMode::TARGET ? PREFILTER_MIN_VOTES : PREFILTER_MIN_VOTES_DIRECTION);
+}
+
+void RingPrefilter::_sample(const Mat& img, PixelFormat format, int scale) {
+    _luma.resize(_rows * _cols);
+    for (int i=0; i < _rows; i++) {
+        // the middle pixel of every block , the rings are wide enough to survive point sampling
+        const uchar* row = img.ptr<uchar>(i * scale + scale / 2);
+        uchar* luma = &_luma[i * _cols];
+        for (int j=0; j < _cols; j++) {
+            luma[j] = luma_pixel(row, j * scale + scale / 2, format);
+        }
+    }
+}
+
+void RingPrefilter::_find_edges() {
+    _magnitudes.assign(_rows * _cols, 0);
+    int histogram[PREFILTER_MAX_MAGNITUDE + 1] = {0};
+    for (int i=1; i < _rows - 1; i++) {
+        const uchar* p = &_luma[i * _cols];
+        short* magnitude = &_magnitudes[i * _cols];
+        for (int j=1; j < _cols - 1; j++) {
+            magnitude[j] = static_cast<short>(abs(p[j + 1] - p[j - 1]) + abs(p[j + _cols] - p[j - _cols]));
+            histogram[magnitude[j]]++;
+        }
+    }
+    // the weakest magnitude that is still in the strongest PREFILTER_EDGE_PERCENT
+    int edges = _rows * _cols * PREFILTER_EDGE_PERCENT / 100;
+    int threshold = PREFILTER_MAX_MAGNITUDE;
+    for (int count = histogram[threshold]; threshold > PREFILTER_MIN_GRADIENT && count < edges; count += histogram[--threshold]);
+
+    _edges.clear();
+    for (int i=1; i < _rows - 1; i++) {
+        const uchar* p = &_luma[i * _cols];
+        const short* magnitude = &_magnitudes[i * _cols];
+        for (int j=1; j < _cols - 1; j++) {
+            if (magnitude[j] < threshold) {
+                continue;
+            }
+            int gx = p[j + 1] - p[j - 1], gy = p[j + _cols] - p[j - _cols];
+            // a step is 2 pixels wide after central differences , only its middle votes
+            int across = abs(gx) >= abs(gy) ? 1 : _cols;
+            if (magnitude[j] < magnitude[j - across] || magnitude[j] <= magnitude[j + across]) {
+                continue;
+            }
+            _edges.push_back(i * _cols + j);
+            _edges.push_back(gx);
+            _edges.push_back(gy);
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef ring_prefilter_hpp
+#define ring_prefilter_hpp
+
+#include <opencv2/core/mat.hpp>
+#include <vector>
+#include "abstract_detector.hpp"
+#include "luma_img.hpp"
+
+#define PREFILTER_WORK_WIDTH 160        // one row and column in 4 of a 640 pixels frame
+#define PREFILTER_MIN_GRADIENT 24       // central difference , about a 12 gray levels step
+#define PREFILTER_EDGE_PERCENT 10       // only the strongest edges vote
+#define PREFILTER_MIN_RADIUS 2          // in work pixels
+#define PREFILTER_MIN_VOTES 180         // votes of the best 3x3 cells , less is no concentric structure
+#define PREFILTER_MIN_VOTES_DIRECTION 110   // a ring cut by the border has fewer edges
+
+using namespace cv;
+
+/**
+ * first stage of the full frame search , rejects frames that clearly don't have concentric rings
+ * the frame is point sampled to about PREFILTER_WORK_WIDTH pixels wide , the strongest edges vote along their
+ * gradient line into a half resolution grid and the frame is promising only if many edges point at the same place
+ * (the common center of the rings) . straight edges , texture and noise spread their votes.
+ * the test is tuned to let every target through , a frame it passes may still have no target
+ */
+namespace VehicleModule {
+    namespace Algorithm {
+        class RingPrefilter {
+        public:
+            /**
+             * @param mode in DIRECTION mode the center may be outside the frame
+             */
+            RingPrefilter(DetectionMode mode);
+            /**
+             * @param  img gray , BGR or YUYV image , may be a ROI
+             * @return false if the image surely has no target (or has an unsupported type)
+             */
+            bool is_promising(const Mat& img);
+            /**
+             * @return the number of votes of the best center in the last image
+             */
+            int get_last_votes() const { return _last_votes; }
+        private:
+            DetectionMode      _mode;
+            int                _rows, _cols;
+            int                _last_votes;
+            std::vector<uchar> _luma;
+            std::vector<short> _magnitudes;
+            std::vector<int>   _edges;      // index , gx and gy of every voting edge
+            std::vector<int>   _votes;
+
+            void _sample(const Mat& img, PixelFormat format, int scale);
+            void _find_edges();
+        };
+    }
+}
+
+#endif /* ring_prefilter_hpp */
@@ -0,0 +1,25 @@
+#include "target_predictor.hpp"
+#include "ground_projection.hpp"
+
+using namespace VehicleModule::Algorithm;
+using namespace VehicleModule::Common;
+
+TargetPredictor::TargetPredictor(const TelemetryHistory& history)
+: _history(history) {}
+
+bool TargetPredictor::predict(double right, double forward, double height, long long capture_time, long long now,
+                              double& out_right, double& out_forward) const {
+    out_right = right;
+    out_forward = forward;
+    Telemetry then_state, now_state;
+    double moved[3];
+    if (height <= 0 || !_history.try_get_at(capture_time, then_state) || !_history.try_get_at(now, now_state)
+        || !_history.try_get_displacement(capture_time, now, moved)) {
+        return false;
+    }
+
+    double north, east;
+    body_to_ground(right, forward, height, then_state.roll, then_state.pitch, then_state.yaw, north, east);
+    ground_to_body(north - moved[0], east - moved[1], now_state.yaw, out_right, out_forward);
+    return true;
+}
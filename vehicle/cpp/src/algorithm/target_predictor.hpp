@@ -0,0 +1,38 @@
+#ifndef target_predictor_hpp
+#define target_predictor_hpp
+
+#include "../common/telemetry_history.hpp"
+
+/**
+ * where a target seen in an old frame is now , relative to the vehicle
+ * the offset of the target in the frame is put on the ground with the attitude of the capture time (see
+ * ground_projection) , moved back by how far the vehicle flew since (the velocity in the history) and turned back to
+ * the heading of now . the target itself is assumed not to move
+ */
+namespace VehicleModule {
+    namespace Algorithm {
+        class TargetPredictor {
+        public:
+            /**
+             * @param history the snapshots of the vehicle
+             */
+            TargetPredictor(const Common::TelemetryHistory& history);
+            /**
+             * @param  right        meters , offset of the target in the frame to the right of the vehicle (at the height of the capture)
+             * @param  forward      meters , offset of the target in the frame ahead of the vehicle
+             * @param  height       meters , at the capture time
+             * @param  capture_time ms
+             * @param  now          ms
+             * @param  out_right    meters , where the target is now to the right of the vehicle , level
+             * @param  out_forward  meters , where the target is now ahead of the vehicle , level
+             * @return false if the history doesn't cover the capture time or now , out is the offset in the frame then
+             */
+            bool predict(double right, double forward, double height, long long capture_time, long long now,
+                         double& out_right, double& out_forward) const;
+        private:
+            const Common::TelemetryHistory& _history;
+        };
+    }
+}
+
+#endif /* target_predictor_hpp */
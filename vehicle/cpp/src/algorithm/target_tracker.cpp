@@ -0,0 +1,123 @@
+#include "target_tracker.hpp"
+
+using namespace VehicleModule::Algorithm;
+using namespace std;
+
+TargetTracker::TargetTracker(PyramidDetector::Detector detector)
+: _detector(detector), _full_frame_detector(detector), _tracking(false), _misses(0), _last_timestamp(0),
+  _state(arma::zeros<arma::mat>(6, 1)), _covariance(arma::eye<arma::mat>(6, 6)) {}
+
+bool TargetTracker::find(const Mat& img, long long timestamp, Point& out) {
+    double radius;
+    return find(img, timestamp, out, radius);
+}
+
+bool TargetTracker::find(const Mat& img, long long timestamp, Point& out, double& radius) {
+    BullseyeResult result;
+    if (!find(img, timestamp, result)) {
+        return false;
+    }
+    out = result.center;
+    radius = result.radius;
+    return true;
+}
+
+bool TargetTracker::find(const Mat& img, long long timestamp, BullseyeResult& out) {
+    if (_tracking) {
+        double dt = TRACKER_DEFAULT_DT;
+        if (timestamp > _last_timestamp) {
+            dt = min((timestamp - _last_timestamp) / 1000.0, TRACKER_MAX_DT);
+        }
+        _last_timestamp = timestamp;
+        _predict(dt);
+
+        Rect window = _search_window(img);
+        if (window.width >= TRACKER_MIN_ROI_SIZE && window.height >= TRACKER_MIN_ROI_SIZE) {
+            if (_detector->find(img(window), out)) {
+                _correct(out.center, out.radius);
+                _misses = 0;
+                out.center = Point(cvRound(_state(0, 0)), cvRound(_state(1, 0)));
+                out.radius = _state(2, 0);
+                return true;
+            }
+        }
+        if (++_misses < TRACKER_MAX_MISSES) {
+            return false;
+        }
+        _tracking = false;
+    }
+
+    if (!_full_frame_detector.find(img, out)) {
+        return false;
+    }
+    _init(out.center, out.radius, timestamp);
+    return true;
+}
+
+void TargetTracker::reset() {
+    _tracking = false;
+    _misses = 0;
+    _full_frame_detector.reset();
+}
+
+bool TargetTracker::is_tracking() const {
+    return _tracking;
+}
+
+void TargetTracker::_init(const Point& center, double radius, long long timestamp) {
+    _state.zeros();
+    _state(0, 0) = center.x;
+    _state(1, 0) = center.y;
+    _state(2, 0) = radius;
+    _covariance.zeros();
+    for (int i=0; i < 3; i++) {
+        _covariance(i, i) = TRACKER_MEASUREMENT_NOISE;
+        _covariance(i + 3, i + 3) = TRACKER_INITIAL_VELOCITY_VARIANCE;
+    }
+    _tracking = true;
+    _misses = 0;
+    _last_timestamp = timestamp;
+}
+
+void TargetTracker::_predict(double dt) {
+    arma::mat transition = arma::eye<arma::mat>(6, 6);
+    arma::mat noise = arma::zeros<arma::mat>(6, 6);
+    // white acceleration noise for each of x , y and r
+    double spectral_density[3] = {TRACKER_POSITION_NOISE, TRACKER_POSITION_NOISE, TRACKER_RADIUS_NOISE};
+    for (int i=0; i < 3; i++) {
+        transition(i, i + 3) = dt;
+        noise(i, i) = spectral_density[i] * dt * dt * dt / 3;
+        noise(i, i + 3) = noise(i + 3, i) = spectral_density[i] * dt * dt / 2;
+        noise(i + 3, i + 3) = spectral_density[i] * dt;
+    }
+    _state = transition * _state;
+    _covariance = transition * _covariance * transition.t() + noise;
+}
+
+void TargetTracker::_correct(const Point& center, double radius) {
+    arma::mat observation = arma::zeros<arma::mat>(3, 6);
+    arma::mat measurement(3, 1);
+    for (int i=0; i < 3; i++) {
+        observation(i, i) = 1;
+    }
+    measurement(0, 0) = center.x;
+    measurement(1, 0) = center.y;
+    measurement(2, 0) = radius;
+
+    arma::mat innovation_covariance = observation * _covariance * observation.t()
+                                      + TRACKER_MEASUREMENT_NOISE * arma::eye<arma::mat>(3, 3);
+    arma::mat gain = _covariance * observation.t() * arma::inv(innovation_covariance);
+    _state = _state + gain * (measurement - observation * _state);
+    _covariance = (arma::eye<arma::mat>(6, 6) - gain * observation) * _covariance;
+}
+
+Rect TargetTracker::_search_window(const Mat& img) const {
+    double uncertainty = sqrt(max(_covariance(0, 0), _covariance(1, 1)));
+    int half_size = static_cast<int>(max(_state(2, 0), 0.0) * TRACKER_ROI_MARGIN + TRACKER_ROI_SIGMAS * uncertainty) + TRACKER_ROI_PADDING;
+    // the state is in pixels of the whole frame , the window is cut from img
+    Size whole;
+    Point offset;
+    img.locateROI(whole, offset);
+    int x = cvRound(_state(0, 0)) - offset.x, y = cvRound(_state(1, 0)) - offset.y;
+    return Rect(x - half_size, y - half_size, 2 * half_size, 2 * half_size) & Rect(0, 0, img.cols, img.rows);
+}
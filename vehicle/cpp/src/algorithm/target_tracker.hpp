@@ -0,0 +1,81 @@
+#ifndef target_tracker_hpp
+#define target_tracker_hpp
+
+#include <opencv2/core/mat.hpp>
+#include <opencv2/core/types.hpp>
+#include <armadillo>
+#include "abstract_detector.hpp"
+#include "pyramid_detector.hpp"
+
+#define TRACKER_MAX_MISSES 3
+#define TRACKER_ROI_MARGIN 1.5
+#define TRACKER_ROI_PADDING 16
+#define TRACKER_ROI_SIGMAS 3
+#define TRACKER_MIN_ROI_SIZE 16
+#define TRACKER_DEFAULT_DT (1 / 30.0)
+#define TRACKER_MAX_DT 1.0
+#define TRACKER_INITIAL_VELOCITY_VARIANCE 10000
+#define TRACKER_POSITION_NOISE 100
+#define TRACKER_RADIUS_NOISE 25
+#define TRACKER_MEASUREMENT_NOISE 4
+
+using namespace cv;
+
+/**
+ * temporal tracking of the target between frames
+ * a constant velocity kalman filter over the target center and radius (in pixels) predicts where the target
+ * will be in the next frame and the detector runs only on a window around the prediction.
+ * after TRACKER_MAX_MISSES frames in a row without detection the tracker falls back to a full frame search
+ * (through PyramidDetector)
+ */
+namespace VehicleModule {
+    namespace Algorithm {
+        class TargetTracker {
+        public:
+            /**
+             * @param detector engine to run on the search window and on the full frame (see DetectorRegistry)
+             */
+            TargetTracker(PyramidDetector::Detector detector);
+            /**
+             * find the target in the frame
+             * @param  img       input image
+             * @param  timestamp capture time of the frame in milliseconds , used for the motion model
+             * @param  out       filtered center of target in pixels if we found one
+             * @return true if found target in this frame else false
+             */
+            bool find(const Mat& img, long long timestamp, Point& out);
+            /**
+             * same as find and also reports the filtered radius of the outer ring in pixels
+             */
+            bool find(const Mat& img, long long timestamp, Point& out, double& radius);
+            /**
+             * same as find , the center and radius are the filtered ones and the confidence is of the last detection
+             */
+            bool find(const Mat& img, long long timestamp, BullseyeResult& out);
+            /**
+             * drop the current track , the next frame is searched from scratch
+             * should be called after the camera moved in a way the motion model doesn't know about
+             */
+            void reset();
+            /**
+             * @return true if the next frame will be searched only around the prediction
+             */
+            bool is_tracking() const;
+        private:
+            PyramidDetector::Detector _detector;
+            PyramidDetector           _full_frame_detector;
+            bool                      _tracking;
+            int                       _misses;
+            long long                 _last_timestamp;
+            arma::mat                 _state;       // x y r vx vy vr
+            arma::mat                 _covariance;
+
+            void _init(const Point& center, double radius, long long timestamp);
+            void _predict(double dt);
+            void _correct(const Point& center, double radius);
+            Rect _search_window(const Mat& img) const;     // in pixels of img
+        };
+    }
+}
+
+#endif /* target_tracker_hpp */
@@ -0,0 +1,128 @@
+#include "threshold.hpp"
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+using namespace VehicleModule::Algorithm;
+
+static uchar trimmed_mean(const int* histogram, int count) {
+    int bucket[THRESHOLD_HISTOGRAM_SIZE];
+    memcpy(bucket, histogram, sizeof(bucket));
+
+    int low_count = count * THRESHOLD_TRIM_PERCENT / 100;
+    int high_count = low_count;
+    for (int i=0; i < THRESHOLD_HISTOGRAM_SIZE && (low_count > 0 || high_count > 0); i++) {
+        int low_to_remove = min(low_count, bucket[i]);
+        int high_to_remove = min(high_count, bucket[THRESHOLD_HISTOGRAM_SIZE - i - 1]);
+        low_count -= low_to_remove;
+        high_count -= high_to_remove;
+        bucket[i] -= low_to_remove;
+        bucket[THRESHOLD_HISTOGRAM_SIZE - i - 1] -= high_to_remove;
+    }
+
+    long long sum = 0;
+    int remaining = 0;
+    for (int i=0; i < THRESHOLD_HISTOGRAM_SIZE; i++) {
+        remaining += bucket[i];
+        sum += (long long)bucket[i] * i;
+    }
+    return remaining ? static_cast<uchar>(sum / remaining) : 0;
+}
+
+static uchar otsu(const int* histogram, int count) {
+    double total_sum = 0;
+    for (int i=0; i < THRESHOLD_HISTOGRAM_SIZE; i++) {
+        total_sum += (double)histogram[i] * i;
+    }
+
+    double black_sum = 0, max_variance = -1;
+    int black_count = 0, best = 0;
+    for (int i=0; i < THRESHOLD_HISTOGRAM_SIZE; i++) {
+        black_count += histogram[i];
+        if (black_count == 0) {
+            continue;
+        }
+        int white_count = count - black_count;
+        if (white_count == 0) {
+            break;
+        }
+        black_sum += (double)histogram[i] * i;
+        double black_mean = black_sum / black_count;
+        double white_mean = (total_sum - black_sum) / white_count;
+        double variance = (double)black_count * white_count * (black_mean - white_mean) * (black_mean - white_mean);
+        if (variance > max_variance) {
+            max_variance = variance;
+            best = i;
+        }
+    }
+    // pixels equal to the level belong to the black class , the zero crossing sits just above them
+    return static_cast<uchar>(min(best + 1, THRESHOLD_HISTOGRAM_SIZE - 1));
+}
+
+template <PixelFormat format>
+static int get_luma_histogram(const Mat& img, int (*sub_histograms)[THRESHOLD_HISTOGRAM_SIZE]) {
+    const int step = THRESHOLD_SAMPLE_STEP;
+    const int unrolled_cols = img.cols - 3 * step;
+    int count = 0;
+    for (int i=0; i < img.rows; i += step) {
+        const uchar* row = img.ptr<uchar>(i);
+        int j = 0;
+        for (; j < unrolled_cols; j += 4 * step) {
+            sub_histograms[0][luma_pixel(row, j, format)]++;
+            sub_histograms[1][luma_pixel(row, j + step, format)]++;
+            sub_histograms[2][luma_pixel(row, j + 2 * step, format)]++;
+            sub_histograms[3][luma_pixel(row, j + 3 * step, format)]++;
+            count += 4;
+        }
+        for (; j < img.cols; j += step) {
+            sub_histograms[0][luma_pixel(row, j, format)]++;
+            count++;
+        }
+    }
+    return count;
+}
+
+int VehicleModule::Algorithm::get_histogram(const Mat& img, int* histogram) {
+    int sub_histograms[4][THRESHOLD_HISTOGRAM_SIZE];
+    memset(sub_histograms, 0, sizeof(sub_histograms));
+
+    PixelFormat format;
+    int count = 0;
+    if (try_get_pixel_format(img, format)) {
+        switch (format) {
+            case PixelFormat::GRAY:
+                count = get_luma_histogram<PixelFormat::GRAY>(img, sub_histograms);
+                break;
+            case PixelFormat::BGR:
+                count = get_luma_histogram<PixelFormat::BGR>(img, sub_histograms);
+                break;
+            case PixelFormat::YUYV:
+                count = get_luma_histogram<PixelFormat::YUYV>(img, sub_histograms);
+                break;
+        }
+    }
+
+    for (int i=0; i < THRESHOLD_HISTOGRAM_SIZE; i++) {
+        histogram[i] = sub_histograms[0][i] + sub_histograms[1][i] + sub_histograms[2][i] + sub_histograms[3][i];
+    }
+    return count;
+}
+
+uchar VehicleModule::Algorithm::get_threshold(const Mat& img, ThresholdMethod method) {
+    int histogram[THRESHOLD_HISTOGRAM_SIZE];
+    int count = get_histogram(img, histogram);
+    if (count == 0) {
+        return 0;
+    }
+
+    uchar threshold = 0;
+    switch (method) {
+        case ThresholdMethod::TRIMMED_MEAN:
+            threshold = trimmed_mean(histogram, count);
+            break;
+        case ThresholdMethod::OTSU:
+            threshold = otsu(histogram, count);
+            break;
+    }
+    return max(threshold, (uchar)1);
+}
@@ -0,0 +1,48 @@
+#ifndef threshold_hpp
+#define threshold_hpp
+
+#include <opencv2/core/mat.hpp>
+#include "luma_img.hpp"
+
+#define THRESHOLD_SAMPLE_STEP 4
+#define THRESHOLD_TRIM_PERCENT 10
+#define THRESHOLD_HISTOGRAM_SIZE 256
+
+using namespace cv;
+
+/**
+ * thresholding stage that runs before the vectorizer.
+ * the vectorizer treats every pixel above the zero value as white and every pixel below it as black
+ * so the zero value must follow the lighting of the scene instead of being a fixed number
+ */
+namespace VehicleModule {
+    namespace Algorithm {
+
+        enum class ThresholdMethod
+        {
+            TRIMMED_MEAN,
+            OTSU
+        };
+
+        /**
+         * builds a histogram of the luminance of the image on a subsampled grid (every THRESHOLD_SAMPLE_STEP row and column)
+         * the counting is spread over 4 interleaved histograms so consecutive pixels with the same value
+         * don't stall on the same counter
+         * @param img       gray , BGR or YUYV image (see PixelFormat) , may be a non continuous sub region
+         * @param histogram output histogram with THRESHOLD_HISTOGRAM_SIZE bins
+         * @return number of sampled pixels (0 for an unsupported image type)
+         */
+        int get_histogram(const Mat& img, int* histogram);
+        /**
+         * computes the zero value for the vectorizer
+         * TRIMMED_MEAN - mean of the pixels without the THRESHOLD_TRIM_PERCENT darkest and brightest pixels
+         * OTSU         - the level that maximizes the between class variance of the black and white pixels
+         * @param  img    gray , BGR or YUYV image
+         * @param  method how to pick the level from the histogram
+         * @return threshold in [1,255] (0 is reserved by the vectorizer for 'use the default value' and returned only for an empty or unsupported image)
+         */
+        uchar get_threshold(const Mat& img, ThresholdMethod method = ThresholdMethod::OTSU);
+    }
+}
+
+#endif /* threshold_hpp */
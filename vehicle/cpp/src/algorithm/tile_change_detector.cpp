@@ -0,0 +1,125 @@
+#include "tile_change_detector.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CHANGE_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define CHANGE_SSE2
+#endif
+
+using namespace VehicleModule::Algorithm;
+
+static int sum_of_absolute_differences(const uchar* a, const uchar* b, int n) {
+    int i = 0, sum = 0;
+#if defined(CHANGE_NEON)
+    uint32x4_t sums = vdupq_n_u32(0);
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t difference = vabdq_u8(vld1q_u8(a + i), vld1q_u8(b + i));
+        sums = vpadalq_u16(sums, vpaddlq_u8(difference));
+    }
+    uint32_t lanes[4];
+    vst1q_u32(lanes, sums);
+    sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#elif defined(CHANGE_SSE2)
+    __m128i sums = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        __m128i difference = _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                                           _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        sums = _mm_add_epi32(sums, difference);
+    }
+    sum = _mm_cvtsi128_si32(sums) + _mm_cvtsi128_si32(_mm_srli_si128(sums, 8));
+#endif
+    for (; i < n; i++) {
+        sum += std::abs(a[i] - b[i]);
+    }
+    return sum;
+}
+
+TileChangeDetector::TileChangeDetector()
+: _rows(0), _cols(0), _tile_rows(0), _tile_cols(0), _has_reference(false), _has_current(false) {}
+
+void TileChangeDetector::_resize(int rows, int cols) {
+    _rows = rows;
+    _cols = cols;
+    _tile_rows = (rows + CHANGE_TILE_SIZE - 1) / CHANGE_TILE_SIZE;
+    _tile_cols = (cols + CHANGE_TILE_SIZE - 1) / CHANGE_TILE_SIZE;
+    int compared_rows = (rows + CHANGE_ROW_STEP - 1) / CHANGE_ROW_STEP;
+    _reference.assign(compared_rows * cols, 0);
+    _current.assign(compared_rows * cols, 0);
+    _sums.assign(_tile_rows * _tile_cols, 0);
+    _changed.assign(_tile_rows * _tile_cols, false);
+    _has_reference = false;
+}
+
+bool TileChangeDetector::compare(const Mat& img) {
+    _has_current = false;
+    PixelFormat format;
+    if (!try_get_pixel_format(img, format) || img.rows == 0 || img.cols == 0) {
+        return false;
+    }
+    if (img.rows != _rows || img.cols != _cols) {
+        _resize(img.rows, img.cols);
+    }
+
+    std::fill(_sums.begin(), _sums.end(), 0);
+    for (int row = 0, i = 0; row < _rows; row += CHANGE_ROW_STEP, i++) {
+        uchar* current = &_current[i * _cols];
+        const uchar* reference = &_reference[i * _cols];
+        luma_row(img.ptr<uchar>(row), current, _cols, format);
+        int* sums = &_sums[(row / CHANGE_TILE_SIZE) * _tile_cols];
+        for (int tile = 0; tile < _tile_cols; tile++) {
+            int begin = tile * CHANGE_TILE_SIZE;
+            sums[tile] += sum_of_absolute_differences(current + begin, reference + begin, std::min(CHANGE_TILE_SIZE, _cols - begin));
+        }
+    }
+    _has_current = true;
+    if (!_has_reference) {
+        return false;
+    }
+
+    for (int tile_row = 0; tile_row < _tile_rows; tile_row++) {
+        int tile_height = std::min(CHANGE_TILE_SIZE, _rows - tile_row * CHANGE_TILE_SIZE);
+        int compared_rows = (tile_height + CHANGE_ROW_STEP - 1) / CHANGE_ROW_STEP;
+        for (int tile_col = 0; tile_col < _tile_cols; tile_col++) {
+            int tile_width = std::min(CHANGE_TILE_SIZE, _cols - tile_col * CHANGE_TILE_SIZE);
+            int tile = tile_row * _tile_cols + tile_col;
+            _changed[tile] = _sums[tile] > CHANGE_TILE_THRESHOLD * compared_rows * tile_width;
+        }
+    }
+    return true;
+}
+
+void TileChangeDetector::accept() {
+    if (_has_current) {
+        _reference.swap(_current);
+        _has_reference = true;
+        _has_current = false;
+    }
+}
+
+bool TileChangeDetector::any_changed() const {
+    return std::find(_changed.begin(), _changed.end(), true) != _changed.end();
+}
+
+bool TileChangeDetector::is_changed(const Rect& region) const {
+    Rect inside = region & Rect(0, 0, _cols, _rows);
+    if (inside.width <= 0 || inside.height <= 0) {
+        return false;
+    }
+    for (int tile_row = inside.y / CHANGE_TILE_SIZE; tile_row <= (inside.y + inside.height - 1) / CHANGE_TILE_SIZE; tile_row++) {
+        for (int tile_col = inside.x / CHANGE_TILE_SIZE; tile_col <= (inside.x + inside.width - 1) / CHANGE_TILE_SIZE; tile_col++) {
+            if (_changed[tile_row * _tile_cols + tile_col]) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void TileChangeDetector::reset() {
+    _has_reference = false;
+    _has_current = false;
+}
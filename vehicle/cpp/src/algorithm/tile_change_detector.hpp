@@ -0,0 +1,64 @@
+#ifndef tile_change_detector_hpp
+#define tile_change_detector_hpp
+
+#include <opencv2/core/mat.hpp>
+#include <opencv2/core/types.hpp>
+#include <vector>
+#include "luma_img.hpp"
+
+#define CHANGE_TILE_SIZE 32         // pixels
+#define CHANGE_ROW_STEP 2           // every other row is compared
+#define CHANGE_TILE_THRESHOLD 6     // mean absolute luminance difference of a changed tile , above the sensor noise
+
+using namespace cv;
+
+/**
+ * finds the parts of a frame that changed since a reference frame
+ * the frame is split to CHANGE_TILE_SIZE tiles and every tile gets the sum of absolute differences of its
+ * luminance against the reference (SSE2 / NEON) . the reference is kept until 'accept' is called so a slow
+ * drift (the drone descends a little every frame) adds up until it is seen as a change
+ */
+namespace VehicleModule {
+    namespace Algorithm {
+        class TileChangeDetector {
+        public:
+            TileChangeDetector();
+            /**
+             * compare the frame to the reference
+             * @param  img gray , BGR or YUYV image
+             * @return false if there is nothing to compare to (no reference , other size or unsupported type)
+             */
+            bool compare(const Mat& img);
+            /**
+             * make the frame of the last 'compare' call the reference
+             */
+            void accept();
+            /**
+             * @return true if any tile of the last compared frame changed
+             */
+            bool any_changed() const;
+            /**
+             * @param  region rectangle in pixels of the frame , may be partly outside the frame
+             * @return true if a tile that touches the region changed
+             */
+            bool is_changed(const Rect& region) const;
+            /**
+             * forget the reference , the next compare returns false
+             */
+            void reset();
+        private:
+            int                _rows, _cols;
+            int                _tile_rows, _tile_cols;
+            bool               _has_reference;
+            bool               _has_current;
+            std::vector<uchar> _reference;      // luminance of the compared rows of the reference frame
+            std::vector<uchar> _current;        // same for the last compared frame
+            std::vector<int>   _sums;           // sum of absolute differences per tile
+            std::vector<bool>  _changed;
+
+            void _resize(int rows, int cols);
+        };
+    }
+}
+
+#endif /* tile_change_detector_hpp */
@@ -0,0 +1,13 @@
+#include "vectorizer_detector.hpp"
+
+using namespace VehicleModule::Algorithm;
+
+VectorizerDetector::VectorizerDetector(DetectionMode mode, double tolerance)
+: _mode(mode), _tolerance(tolerance) {}
+
+bool VectorizerDetector::find(const Mat& img, BullseyeResult& out) {
+    if (_mode == DetectionMode::TARGET) {
+        return find_bullseye(img, out, _tolerance);
+    }
+    return find_bullseye_direction(img, out, _tolerance);
+}
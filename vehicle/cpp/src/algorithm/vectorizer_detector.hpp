@@ -0,0 +1,24 @@
+#ifndef vectorizer_detector_hpp
+#define vectorizer_detector_hpp
+
+#include "abstract_detector.hpp"
+#include "image_algorithm.hpp"
+
+/**
+ * the built in detector , traces the image into curves (ImgVectorizer) and looks for concentric circles among them
+ * the curves are simplified to 'tolerance' pixels before they are ranked and fitted (0 keeps every pixel step)
+ */
+namespace VehicleModule {
+    namespace Algorithm {
+        class VectorizerDetector : public AbstractDetector {
+        public:
+            VectorizerDetector(DetectionMode mode, double tolerance = VECTORIZER_TOLERANCE);
+            bool find(const Mat& img, BullseyeResult& out);
+        private:
+            DetectionMode _mode;
+            double        _tolerance;
+        };
+    }
+}
+
+#endif /* vectorizer_detector_hpp */
@@ -0,0 +1,493 @@
+//
+//  detector_benchmark.cpp
+//  vehicle
+//
+//  offline benchmark of the bullseye detectors . build with 'make benchmark'
+//
+//  usage: detector_benchmark [--corpus manifest] [--synthetic count] [--seed seed] [--repeat count]
+//                            [--detector name]... [--output report.json]
+//
+//  the manifest lists recorded frames with their ground truth , one frame per line:
+//      <image path> <center x> <center y> <outer radius>    a frame with a target
+//      <image path> -                                       a frame without a target
+//  paths are relative to the manifest , lines starting with '#' are ignored.
+//  synthetic frames are generated from the seed so two runs with the same arguments see the same corpus.
+//
+//  every frame is run 'repeat' times (after one warm up run) , the latency percentiles are over all the runs
+//  and the accuracy is from the first run . every detector entry also reports the RingPrefilter of its mode :
+//  its latency , the part of the frames without a target it rejects and the part of the frames the detector
+//  got right that it would have rejected (a miss of the cascade) .
+//  the stages of find_bullseye_dual are measured with the traced curves simplified (VECTORIZER_TOLERANCE) and
+//  with every pixel step kept ("stages_exact") , "vectorizer_exact" gives the accuracy without the simplification.
+//  the report (json) can be kept as a baseline and diffed against the report of a detector change
+//
+
+#include <opencv2/core/mat.hpp>
+#include <opencv2/core/types.hpp>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "image_algorithm.hpp"
+#include "detector_registry.hpp"
+#include "ring_prefilter.hpp"
+
+#define SYNTHETIC_WIDTH 640
+#define SYNTHETIC_HEIGHT 480
+#define SYNTHETIC_RINGS 4
+#define SYNTHETIC_NEGATIVE_PERCENT 20   // frames without a target
+#define SYNTHETIC_PARTIAL_PERCENT 20    // frames with the center of the target near or outside the border
+#define ACCURACY_MIN_TOLERANCE 5        // a found center is right if it is this close to the ground truth
+#define ACCURACY_RADIUS_TOLERANCE 0.1   // or this part of the outer radius
+
+using namespace cv;
+using namespace std;
+using namespace VehicleModule::Algorithm;
+
+// every allocation of the process is counted , the detectors are compared by the allocations made during their calls
+static std::atomic<long long> allocations(0);
+
+void* operator new(size_t size) {
+    allocations++;
+    void* p = malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+static long long count_allocations() {
+    return allocations.load();
+}
+
+struct Frame {
+    string  name;
+    Mat     img;
+    bool    has_target;
+    Point2d center;
+    double  radius;
+
+    // the whole target is in the frame , only then a TARGET mode detector is expected to find it
+    bool is_whole() const {
+        return has_target && center.x - radius >= 0 && center.y - radius >= 0 &&
+               center.x + radius < img.cols && center.y + radius < img.rows;
+    }
+    // some of the target is in the frame
+    bool is_visible() const {
+        return has_target && center.x + radius >= 0 && center.y + radius >= 0 &&
+               center.x - radius < img.cols && center.y - radius < img.rows;
+    }
+};
+
+struct Accuracy {
+    int            positives, true_positives, false_positives, false_negatives, true_negatives;
+    vector<double> errors;
+
+    Accuracy() : positives(0), true_positives(0), false_positives(0), false_negatives(0), true_negatives(0) {}
+};
+
+struct DetectorReport {
+    string            name;
+    DetectionMode     mode;
+    vector<long long> nanoseconds;
+    long long         allocations;
+    int               calls;
+    Accuracy          accuracy;
+    // RingPrefilter in front of the detector
+    vector<long long> prefilter_nanoseconds;
+    int               prefilter_rejected_negatives;   // frames without an expected target that the prefilter rejected
+    int               negatives;
+    int               prefilter_missed;               // frames the detector got right and the prefilter rejected
+    int               found;
+
+    DetectorReport() : allocations(0), calls(0), prefilter_rejected_negatives(0), negatives(0), prefilter_missed(0), found(0) {}
+};
+
+struct StageReport {
+    double                     tolerance;
+    vector<vector<long long> > nanoseconds;     // of every run , by stage
+    vector<long long>          allocations;     // of all the runs , by stage
+    long long                  curves;          // of all the runs
+    long long                  points;
+
+    StageReport(double tolerance = VECTORIZER_TOLERANCE) : tolerance(tolerance), curves(0), points(0) {}
+};
+
+struct Options {
+    string         corpus;
+    int            synthetic;
+    unsigned int   seed;
+    int            repeat;
+    vector<string> detectors;
+    string         output;
+
+    Options() : synthetic(200), seed(1), repeat(5) {}
+};
+
+static const char* stage_name(int stage) {
+    static const char* names[] = {"threshold", "vectorize", "candidate_scoring", "circle_fitting", "clustering"};
+    return names[stage];
+}
+
+static const char* mode_name(DetectionMode mode) {
+    return mode == DetectionMode::TARGET ? "target" : "direction";
+}
+
+static bool parse_options(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (i + 1 >= argc) {
+            cerr << "missing value of " << arg << endl;
+            return false;
+        }
+        string value = argv[++i];
+        if (arg == "--corpus") {
+            options.corpus = value;
+        } else if (arg == "--synthetic") {
+            options.synthetic = atoi(value.c_str());
+        } else if (arg == "--seed") {
+            options.seed = static_cast<unsigned int>(atoi(value.c_str()));
+        } else if (arg == "--repeat") {
+            options.repeat = max(1, atoi(value.c_str()));
+        } else if (arg == "--detector") {
+            options.detectors.push_back(value);
+        } else if (arg == "--output") {
+            options.output = value;
+        } else {
+            cerr << "unknown option " << arg << endl;
+            return false;
+        }
+    }
+    if (options.detectors.empty()) {
+        options.detectors.push_back("vectorizer");
+        options.detectors.push_back("vectorizer_exact");
+        options.detectors.push_back("concentric_circles");
+    }
+    return true;
+}
+
+static bool load_corpus(const string& manifest, vector<Frame>& frames) {
+    ifstream file(manifest.c_str());
+    if (!file) {
+        cerr << "can't open corpus " << manifest << endl;
+        return false;
+    }
+    string directory = manifest.find('/') == string::npos ? "" : manifest.substr(0, manifest.rfind('/') + 1);
+    string line;
+    while (getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        istringstream fields(line);
+        Frame frame;
+        string path, x;
+        fields >> path >> x;
+        frame.name = path;
+        frame.has_target = x != "-";
+        if (frame.has_target) {
+            frame.center.x = atof(x.c_str());
+            fields >> frame.center.y >> frame.radius;
+        }
+        frame.img = imread(path[0] == '/' ? path : directory + path, IMREAD_COLOR);
+        if (frame.img.empty()) {
+            cerr << "can't read frame " << path << endl;
+            return false;
+        }
+        frames.push_back(frame);
+    }
+    return true;
+}
+
+// a printed bullseye seen from above : alternating black and white rings on a lit , noisy ground
+static Frame make_synthetic_frame(int index, mt19937& random) {
+    uniform_real_distribution<double> unit(0, 1);
+    Frame frame;
+    frame.name = "synthetic_" + to_string(index);
+
+    int ground = 90 + static_cast<int>(unit(random) * 100);
+    frame.img = Mat(SYNTHETIC_HEIGHT, SYNTHETIC_WIDTH, CV_8UC3, Scalar(ground * 0.8, ground, ground * 0.9));
+    // things on the ground that are not the target
+    for (int i = 0; i < 3; i++) {
+        Point corner(static_cast<int>(unit(random) * SYNTHETIC_WIDTH), static_cast<int>(unit(random) * SYNTHETIC_HEIGHT));
+        Point size(20 + static_cast<int>(unit(random) * 80), 20 + static_cast<int>(unit(random) * 80));
+        int gray = static_cast<int>(unit(random) * 255);
+        rectangle(frame.img, corner, corner + size, Scalar(gray, gray, gray), FILLED);
+    }
+
+    double kind = unit(random) * 100;
+    frame.has_target = kind >= SYNTHETIC_NEGATIVE_PERCENT;
+    if (frame.has_target) {
+        frame.radius = 30 + unit(random) * 120;
+        if (kind < SYNTHETIC_NEGATIVE_PERCENT + SYNTHETIC_PARTIAL_PERCENT) {
+            // anywhere around the frame , usually cut by the border
+            frame.center = Point2d(-frame.radius / 2 + unit(random) * (SYNTHETIC_WIDTH + frame.radius),
+                                   -frame.radius / 2 + unit(random) * (SYNTHETIC_HEIGHT + frame.radius));
+        } else {
+            frame.center = Point2d(frame.radius + unit(random) * (SYNTHETIC_WIDTH - 2 * frame.radius),
+                                   frame.radius + unit(random) * (SYNTHETIC_HEIGHT - 2 * frame.radius));
+        }
+        // drawn with 4 fractional bits so the center is not snapped to the pixel grid
+        Point center(cvRound(frame.center.x * 16), cvRound(frame.center.y * 16));
+        for (int ring = 0; ring < SYNTHETIC_RINGS; ring++) {
+            int gray = ring % 2 == 0 ? 20 : 235;
+            int radius = cvRound(frame.radius * (SYNTHETIC_RINGS - ring) / SYNTHETIC_RINGS * 16);
+            circle(frame.img, center, radius, Scalar(gray, gray, gray), FILLED, LINE_AA, 4);
+        }
+    }
+
+    Mat signed_img, noise(frame.img.size(), CV_16SC3);
+    frame.img.convertTo(signed_img, CV_16SC3);
+    randn(noise, Scalar::all(0), Scalar::all(6));
+    signed_img += noise;
+    signed_img.convertTo(frame.img, CV_8UC3);
+    GaussianBlur(frame.img, frame.img, Size(3, 3), 0);
+    return frame;
+}
+
+static bool is_expected(const Frame& frame, DetectionMode mode) {
+    return mode == DetectionMode::TARGET ? frame.is_whole() : frame.is_visible();
+}
+
+// @return true if the result is right
+static bool score(const Frame& frame, DetectionMode mode, const BullseyeResult& result, Accuracy& accuracy) {
+    bool expected = is_expected(frame, mode);
+    double error = result.found && frame.has_target ? norm(Point2d(result.center.x, result.center.y) - frame.center) : 0;
+    bool right = result.found && frame.has_target &&
+                 error <= max((double)ACCURACY_MIN_TOLERANCE, ACCURACY_RADIUS_TOLERANCE * frame.radius);
+    if (expected) {
+        accuracy.positives++;
+        if (right) {
+            accuracy.true_positives++;
+            accuracy.errors.push_back(error);
+        } else {
+            accuracy.false_negatives++;
+        }
+    }
+    // a target cut by the border may or may not be found in TARGET mode , only a wrong center is counted against it
+    if (result.found && !right) {
+        accuracy.false_positives++;
+    } else if (!result.found && !expected) {
+        accuracy.true_negatives++;
+    }
+    return right;
+}
+
+template <typename T>
+static double percentile(vector<T> values, double part) {
+    if (values.empty()) {
+        return 0;
+    }
+    sort(values.begin(), values.end());
+    return static_cast<double>(values[static_cast<size_t>(part * (values.size() - 1) + 0.5)]);
+}
+
+static double mean(const vector<double>& values) {
+    double sum = 0;
+    for (double value : values) {
+        sum += value;
+    }
+    return values.empty() ? 0 : sum / values.size();
+}
+
+static double fraction(int part, int whole) {
+    return whole ? static_cast<double>(part) / whole : 0;
+}
+
+static void run_detector(const vector<Frame>& frames, int repeat, DetectorReport& report) {
+    std::shared_ptr<AbstractDetector> detector = DetectorRegistry::get_instance().create(report.name, report.mode);
+    RingPrefilter prefilter(report.mode);
+    for (const Frame& frame : frames) {
+        BullseyeResult result;
+        detector->find(frame.img, result);
+        bool right = score(frame, report.mode, result, report.accuracy);
+
+        bool promising = prefilter.is_promising(frame.img);
+        if (right) {
+            report.found++;
+            report.prefilter_missed += !promising;
+        }
+        if (!is_expected(frame, report.mode)) {
+            report.negatives++;
+            report.prefilter_rejected_negatives += !promising;
+        }
+        for (int i = 0; i < repeat; i++) {
+            auto start = chrono::steady_clock::now();
+            prefilter.is_promising(frame.img);
+            report.prefilter_nanoseconds.push_back(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+        }
+
+        for (int i = 0; i < repeat; i++) {
+            long long allocations_before = count_allocations();
+            auto start = chrono::steady_clock::now();
+            detector->find(frame.img, result);
+            report.nanoseconds.push_back(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+            report.allocations += count_allocations() - allocations_before;
+            report.calls++;
+        }
+    }
+}
+
+static void run_stages(const vector<Frame>& frames, int repeat, StageReport& report) {
+    int num_stages = static_cast<int>(BullseyeStage::COUNT);
+    report.nanoseconds.assign(num_stages, vector<long long>());
+    report.allocations.assign(num_stages, 0);
+    for (const Frame& frame : frames) {
+        BullseyeDetection detection;
+        find_bullseye_dual(frame.img, detection, nullptr, report.tolerance);
+        for (int i = 0; i < repeat; i++) {
+            BullseyeProfile profile(&count_allocations);
+            find_bullseye_dual(frame.img, detection, &profile, report.tolerance);
+            for (int stage = 0; stage < num_stages; stage++) {
+                report.nanoseconds[stage].push_back(profile.nanoseconds[stage]);
+                report.allocations[stage] += profile.allocations[stage];
+            }
+            report.curves += profile.curves;
+            report.points += profile.points;
+        }
+    }
+}
+
+static void write_latency(ostream& out, const vector<long long>& nanoseconds) {
+    out << "\"p50_us\": " << percentile(nanoseconds, 0.5) / 1000
+        << ", \"p90_us\": " << percentile(nanoseconds, 0.9) / 1000
+        << ", \"p99_us\": " << percentile(nanoseconds, 0.99) / 1000
+        << ", \"max_us\": " << percentile(nanoseconds, 1) / 1000;
+}
+
+static void write_stages(ostream& out, const StageReport& stages, long long runs) {
+    out << "{\n    \"tolerance_px\": " << stages.tolerance
+        << ",\n    \"points_per_curve\": " << (stages.curves ? static_cast<double>(stages.points) / stages.curves : 0) << ",\n";
+    for (int stage = 0; stage < static_cast<int>(stages.nanoseconds.size()); stage++) {
+        out << "    \"" << stage_name(stage) << "\": {";
+        write_latency(out, stages.nanoseconds[stage]);
+        out << ", \"allocations_per_frame\": " << (runs ? static_cast<double>(stages.allocations[stage]) / runs : 0) << "}"
+            << (stage + 1 < static_cast<int>(stages.nanoseconds.size()) ? ",\n" : "\n");
+    }
+    out << "  }";
+}
+
+static void write_report(ostream& out, const Options& options, const vector<Frame>& frames,
+                         const StageReport& stages, const StageReport& exact_stages, const vector<DetectorReport>& reports) {
+    long long runs = static_cast<long long>(frames.size()) * options.repeat;
+    out << fixed << setprecision(3);
+    out << "{\n  \"frames\": " << frames.size() << ",\n  \"repeat\": " << options.repeat
+        << ",\n  \"seed\": " << options.seed << ",\n  \"stages\": ";
+    write_stages(out, stages, runs);
+    out << ",\n  \"stages_exact\": ";
+    write_stages(out, exact_stages, runs);
+    out << ",\n  \"detectors\": [\n";
+    for (size_t i = 0; i < reports.size(); i++) {
+        const DetectorReport& report = reports[i];
+        const Accuracy& accuracy = report.accuracy;
+        out << "    {\"name\": \"" << report.name << "\", \"mode\": \"" << mode_name(report.mode) << "\", ";
+        write_latency(out, report.nanoseconds);
+        out << ", \"allocations_per_frame\": " << (report.calls ? static_cast<double>(report.allocations) / report.calls : 0)
+            << ", \"positives\": " << accuracy.positives
+            << ", \"true_positives\": " << accuracy.true_positives
+            << ", \"false_positives\": " << accuracy.false_positives
+            << ", \"false_negatives\": " << accuracy.false_negatives
+            << ", \"true_negatives\": " << accuracy.true_negatives
+            << ", \"recall\": " << fraction(accuracy.true_positives, accuracy.positives)
+            << ", \"precision\": " << fraction(accuracy.true_positives, accuracy.true_positives + accuracy.false_positives)
+            << ", \"mean_error_px\": " << mean(accuracy.errors)
+            << ", \"p95_error_px\": " << percentile(accuracy.errors, 0.95)
+            << ", \"prefilter\": {";
+        write_latency(out, report.prefilter_nanoseconds);
+        out << ", \"rejection_rate\": " << fraction(report.prefilter_rejected_negatives, report.negatives)
+            << ", \"miss_rate\": " << fraction(report.prefilter_missed, report.found) << "}}"
+            << (i + 1 < reports.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+}
+
+static void print_summary(const StageReport& stages, const StageReport& exact_stages, const vector<DetectorReport>& reports) {
+    cout << fixed << setprecision(1);
+    cout << "stage (find_bullseye_dual)       p50 us     p99 us   exact p50 us" << endl;
+    for (int stage = 0; stage < static_cast<int>(stages.nanoseconds.size()); stage++) {
+        cout << setw(30) << left << stage_name(stage) << right
+             << setw(10) << percentile(stages.nanoseconds[stage], 0.5) / 1000
+             << setw(11) << percentile(stages.nanoseconds[stage], 0.99) / 1000
+             << setw(15) << percentile(exact_stages.nanoseconds[stage], 0.5) / 1000 << endl;
+    }
+    cout << setw(30) << left << "points per curve" << right
+         << setw(10) << (stages.curves ? static_cast<double>(stages.points) / stages.curves : 0)
+         << setw(26) << (exact_stages.curves ? static_cast<double>(exact_stages.points) / exact_stages.curves : 0) << endl;
+    cout << endl << "detector                        p50 us     p99 us  allocs   recall  precision  error px  prefilter us  rejected  missed" << endl;
+    for (const DetectorReport& report : reports) {
+        const Accuracy& accuracy = report.accuracy;
+        cout << setw(30) << left << (report.name + " " + mode_name(report.mode)) << right
+             << setw(10) << percentile(report.nanoseconds, 0.5) / 1000
+             << setw(11) << percentile(report.nanoseconds, 0.99) / 1000
+             << setw(8) << (report.calls ? static_cast<double>(report.allocations) / report.calls : 0)
+             << setw(9) << fraction(accuracy.true_positives, accuracy.positives)
+             << setw(11) << fraction(accuracy.true_positives, accuracy.true_positives + accuracy.false_positives)
+             << setw(10) << mean(accuracy.errors)
+             << setw(14) << percentile(report.prefilter_nanoseconds, 0.5) / 1000
+             << setw(10) << fraction(report.prefilter_rejected_negatives, report.negatives)
+             << setw(8) << fraction(report.prefilter_missed, report.found) << endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        return 1;
+    }
+
+    vector<Frame> frames;
+    if (!options.corpus.empty() && !load_corpus(options.corpus, frames)) {
+        return 1;
+    }
+    mt19937 random(options.seed);
+    for (int i = 0; i < options.synthetic; i++) {
+        frames.push_back(make_synthetic_frame(i, random));
+    }
+    if (frames.empty()) {
+        cerr << "empty corpus" << endl;
+        return 1;
+    }
+
+    StageReport stages;
+    StageReport exact_stages(0);
+    run_stages(frames, options.repeat, stages);
+    run_stages(frames, options.repeat, exact_stages);
+
+    vector<DetectorReport> reports;
+    for (const string& name : options.detectors) {
+        for (DetectionMode mode : {DetectionMode::TARGET, DetectionMode::DIRECTION}) {
+            DetectorReport report;
+            report.name = name;
+            report.mode = mode;
+            try {
+                run_detector(frames, options.repeat, report);
+            } catch (const DetectorRegistry::DetectorRegistryException& e) {
+                cerr << e.message << endl;
+                return 1;
+            }
+            reports.push_back(report);
+        }
+    }
+
+    print_summary(stages, exact_stages, reports);
+    if (options.output == "-") {
+        write_report(cout, options, frames, stages, exact_stages, reports);
+    } else if (!options.output.empty()) {
+        ofstream file(options.output.c_str());
+        write_report(file, options, frames, stages, exact_stages, reports);
+    }
+    return 0;
+}
@@ -1,3 +1,6 @@
+#ifndef cpp_service_hpp
+#define cpp_service_hpp
+
 #include "service_provider.hpp"
 #include <string>
 
@@ -11,3 +14,5 @@ namespace VehicleModule {
         };
     }
 };
+
+#endif /* cpp_service_hpp */
@@ -0,0 +1,65 @@
+#include "executor.hpp"
+#include <algorithm>
+#include "gil_lock.hpp"
+
+using namespace VehicleModule::Common;
+
+Executor::Executor(unsigned int num_threads) : _order(0), _stop(false) {
+    if (num_threads == 0) {
+        num_threads = std::max((unsigned int) EXECUTOR_MIN_THREADS, std::thread::hardware_concurrency());
+    }
+    for (unsigned int i = 0; i < num_threads; i++) {
+        _workers.push_back(std::thread(&Executor::_run, this));
+    }
+}
+
+Executor::~Executor() {
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _stop = true;
+    }
+    _changed.notify_all();
+    for (std::thread& worker : _workers) {
+        worker.join();
+    }
+}
+
+void Executor::post(const Task& task) {
+    post_after(0, task);
+}
+
+void Executor::post_after(int delay_ms, const Task& task) {
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _tasks.push(TimedTask{std::chrono::steady_clock::now() + std::chrono::milliseconds(delay_ms), _order++, task});
+    }
+    // every waiting worker may be sleeping till a later task
+    _changed.notify_all();
+}
+
+void Executor::_run() {
+    // the worker was not started by python , it needs a thread state before it can have a GilLock
+    PyGILState_STATE state = PyGILState_Ensure();
+    {
+        ::Common::GilLock gil;
+        gil.unlock();
+        std::unique_lock<std::mutex> guard(_lock);
+        while (!_stop) {
+            if (_tasks.empty()) {
+                _changed.wait(guard);
+                continue;
+            }
+            std::chrono::steady_clock::time_point due = _tasks.top().due;
+            if (std::chrono::steady_clock::now() < due) {
+                _changed.wait_until(guard, due);
+                continue;
+            }
+            Task task = _tasks.top().task;
+            _tasks.pop();
+            guard.unlock();
+            task();
+            guard.lock();
+        }
+    }
+    PyGILState_Release(state);
+}
@@ -0,0 +1,79 @@
+#ifndef executor_hpp
+#define executor_hpp
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#define EXECUTOR_MIN_THREADS 4      // the state functions of the old missions block a worker for a whole state
+
+/**
+ * worker threads shared by all the missions , with timers
+ * a task runs as soon as a worker is free , a delayed task once its time came . every worker has a GilLock so a task
+ * may call python with BEGIN_PYTHON_EXECUTION like a thread that was started by python
+ * tasks should not block (wait for an event instead) , a task that blocks holds its worker till it returns
+ */
+namespace VehicleModule {
+    namespace Common {
+        class Executor {
+        public:
+            typedef std::function<void()> Task;
+
+            /**
+             * the shared one , never destroyed (its workers hold python thread states till the process exits)
+             */
+            static Executor& get_instance() {
+                static Executor* instance = new Executor();
+                return *instance;
+            }
+
+            /**
+             * @param num_threads number of workers , 0 for one per core (at least EXECUTOR_MIN_THREADS)
+             */
+            Executor(unsigned int num_threads = 0);
+            /**
+             * drops the tasks that didn't start and waits for the running ones
+             */
+            ~Executor();
+            /**
+             * may be called from any thread , including a task
+             */
+            void post(const Task& task);
+            /**
+             * @param delay_ms how long from now the task runs at the earliest
+             */
+            void post_after(int delay_ms, const Task& task);
+            unsigned int size() const { return static_cast<unsigned int>(_workers.size()); }
+
+            Executor(Executor const&) = delete;
+            void operator=(Executor const&) = delete;
+        private:
+            struct TimedTask {
+                std::chrono::steady_clock::time_point due;
+                long long                             order;    // tasks that are due together run in the order they were posted
+                Task                                  task;
+            };
+            struct Later {
+                bool operator()(const TimedTask& a, const TimedTask& b) const {
+                    long long gap = (a.due - b.due).count();
+                    return gap != 0 ? gap > 0 : a.order > b.order;
+                }
+            };
+
+            std::priority_queue<TimedTask, std::vector<TimedTask>, Later> _tasks;
+            std::vector<std::thread>                                      _workers;
+            std::mutex                                                    _lock;
+            std::condition_variable                                       _changed;
+            long long                                                     _order;
+            bool                                                          _stop;
+
+            void _run();
+        };
+    }
+}
+
+#endif /* executor_hpp */
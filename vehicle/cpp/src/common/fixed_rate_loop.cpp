@@ -0,0 +1,74 @@
+#include "fixed_rate_loop.hpp"
+#include <algorithm>
+
+using namespace VehicleModule::Common;
+using namespace std::chrono;
+
+FixedRateLoop::FixedRateLoop(double rate)
+: _rate(rate), _running(false), _total_jitter(0) {}
+
+FixedRateLoop::~FixedRateLoop() {
+    stop();
+}
+
+void FixedRateLoop::start(const Task& task) {
+    std::lock_guard<std::mutex> guard(_owner_lock);
+    if (_running) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> statistics_guard(_statistics_lock);
+        _statistics = LoopStatistics();
+        _total_jitter = 0;
+    }
+    _task = task;
+    _running = true;
+    _thread = std::thread(&FixedRateLoop::_run, this);
+}
+
+void FixedRateLoop::stop() {
+    std::lock_guard<std::mutex> guard(_owner_lock);
+    if (!_running) {
+        return;
+    }
+    _running = false;
+    _thread.join();
+}
+
+bool FixedRateLoop::is_running() const {
+    return _running;
+}
+
+LoopStatistics FixedRateLoop::get_statistics() {
+    std::lock_guard<std::mutex> guard(_statistics_lock);
+    return _statistics;
+}
+
+double FixedRateLoop::now_in_seconds() {
+    return duration_cast<duration<double> >(steady_clock::now().time_since_epoch()).count();
+}
+
+void FixedRateLoop::_run() {
+    const steady_clock::duration period = duration_cast<steady_clock::duration>(duration<double>(1 / _rate));
+    steady_clock::time_point deadline = steady_clock::now();
+    while (_running) {
+        std::this_thread::sleep_until(deadline);
+        steady_clock::time_point start = steady_clock::now();
+        double jitter = duration_cast<duration<double, std::micro> >(start - deadline).count();
+        _task(duration_cast<duration<double> >(start.time_since_epoch()).count());
+        steady_clock::time_point end = steady_clock::now();
+
+        deadline += period;
+        bool missed = end > deadline;
+        while (deadline < end) {
+            deadline += period;
+        }
+
+        std::lock_guard<std::mutex> guard(_statistics_lock);
+        _statistics.iterations++;
+        _statistics.deadline_misses += missed;
+        _total_jitter += jitter;
+        _statistics.mean_jitter = _total_jitter / _statistics.iterations;
+        _statistics.max_jitter = std::max(_statistics.max_jitter, jitter);
+    }
+}
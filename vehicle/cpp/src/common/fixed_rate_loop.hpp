@@ -0,0 +1,75 @@
+#ifndef fixed_rate_loop_hpp
+#define fixed_rate_loop_hpp
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * runs a task on its own thread at a fixed rate
+ * the iterations are scheduled on a steady clock from the start , so a late iteration doesn't delay the next ones.
+ * an iteration that overruns its period is a deadline miss : the periods it covered are skipped instead of
+ * running the task back to back to catch up (a controller must not burst on stale input)
+ * the jitter is how late an iteration started after its scheduled time
+ */
+namespace VehicleModule {
+    namespace Common {
+
+        struct LoopStatistics {
+            long long iterations;
+            long long deadline_misses;
+            double    mean_jitter;      // microseconds
+            double    max_jitter;       // microseconds
+
+            LoopStatistics() : iterations(0), deadline_misses(0), mean_jitter(0), max_jitter(0) {}
+        };
+
+        class FixedRateLoop {
+        public:
+            /**
+             * @param time seconds on a steady clock , when the iteration started
+             */
+            typedef std::function<void(double time)> Task;
+
+            /**
+             * @param rate iterations per second
+             */
+            FixedRateLoop(double rate);
+            ~FixedRateLoop();
+            /**
+             * start the thread and reset the statistics , does nothing if already started
+             * the task must not throw
+             */
+            void start(const Task& task);
+            /**
+             * stop the thread and wait for the running iteration to end
+             */
+            void stop();
+            bool is_running() const;
+            double get_rate() const { return _rate; }
+            LoopStatistics get_statistics();
+            /**
+             * @return seconds on the steady clock the tasks get
+             */
+            static double now_in_seconds();
+
+            FixedRateLoop(FixedRateLoop const&) = delete;
+            void operator=(FixedRateLoop const&) = delete;
+        private:
+            double           _rate;
+            Task             _task;
+            std::thread      _thread;
+            std::atomic_bool _running;
+            std::mutex       _owner_lock;           // serializes start / stop
+            std::mutex       _statistics_lock;
+            LoopStatistics   _statistics;
+            double           _total_jitter;
+
+            void _run();
+        };
+    }
+}
+
+#endif /* fixed_rate_loop_hpp */
@@ -0,0 +1,113 @@
+#include "telemetry_history.hpp"
+#include <cmath>
+
+using namespace VehicleModule::Common;
+using namespace std;
+
+static double lerp(double from, double to, double fraction) {
+    return from + (to - from) * fraction;
+}
+
+static double lerp_angle(double from, double to, double fraction) {
+    double difference = remainder(to - from, 2 * M_PI);
+    return remainder(from + difference * fraction, 2 * M_PI);
+}
+
+TelemetryHistory::TelemetryHistory(size_t capacity)
+: _snapshots(capacity), _first(0), _size(0) {}
+
+void TelemetryHistory::add(const Telemetry& telemetry) {
+    lock_guard<mutex> guard(_lock);
+    if (_size && telemetry.timestamp < _at(_size - 1).timestamp) {
+        return;
+    }
+    if (_size == _snapshots.size()) {
+        _first = (_first + 1) % _snapshots.size();
+        _size--;
+    }
+    _snapshots[(_first + _size) % _snapshots.size()] = telemetry;
+    _size++;
+}
+
+void TelemetryHistory::clear() {
+    lock_guard<mutex> guard(_lock);
+    _first = _size = 0;
+}
+
+bool TelemetryHistory::try_get_at(long long timestamp, Telemetry& out) const {
+    lock_guard<mutex> guard(_lock);
+    return _interpolate(timestamp, out);
+}
+
+bool TelemetryHistory::try_get_displacement(long long from, long long to, double out[3]) const {
+    lock_guard<mutex> guard(_lock);
+    Telemetry start, end;
+    if (!_interpolate(from, start) || !_interpolate(to, end)) {
+        return false;
+    }
+    out[0] = out[1] = out[2] = 0;
+    double sign = 1;
+    if (to < from) {
+        swap(from, to);
+        swap(start, end);
+        sign = -1;
+    }
+    // the velocity is linear between snapshots , a trapezoid per snapshot in between
+    Telemetry previous = start;
+    auto add_trapezoid = [&](const Telemetry& current) {
+        double seconds = (current.timestamp - previous.timestamp) / 1000.0;
+        for (int axis = 0; axis < 3; axis++) {
+            out[axis] += sign * (previous.velocity[axis] + current.velocity[axis]) / 2 * seconds;
+        }
+        previous = current;
+    };
+    for (size_t i = 0; i < _size; i++) {
+        if (_at(i).timestamp > from && _at(i).timestamp < to) {
+            add_trapezoid(_at(i));
+        }
+    }
+    add_trapezoid(end);
+    return true;
+}
+
+bool TelemetryHistory::_interpolate(long long timestamp, Telemetry& out) const {
+    if (!_size || timestamp < _at(0).timestamp) {
+        return false;
+    }
+    const Telemetry& newest = _at(_size - 1);
+    if (timestamp >= newest.timestamp) {
+        if (timestamp - newest.timestamp > TELEMETRY_MAX_AGE) {
+            return false;
+        }
+        out = newest;
+        out.timestamp = timestamp;
+        return true;
+    }
+    // the first snapshot after the timestamp
+    size_t low = 0, high = _size - 1;
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        if (_at(middle).timestamp > timestamp) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+    const Telemetry& before = _at(low - 1);
+    const Telemetry& after = _at(low);
+    double fraction = static_cast<double>(timestamp - before.timestamp) / (after.timestamp - before.timestamp);
+    out.timestamp = timestamp;
+    out.roll = lerp_angle(before.roll, after.roll, fraction);
+    out.pitch = lerp_angle(before.pitch, after.pitch, fraction);
+    out.yaw = lerp_angle(before.yaw, after.yaw, fraction);
+    out.altitude = lerp(before.altitude, after.altitude, fraction);
+    // a rangefinder out of range reads 0 , don't interpolate towards it
+    out.rangefinder = before.rangefinder > 0 && after.rangefinder > 0 ? lerp(before.rangefinder, after.rangefinder, fraction)
+                                                                     : (fraction < 0.5 ? before.rangefinder : after.rangefinder);
+    out.latitude = lerp(before.latitude, after.latitude, fraction);
+    out.longitude = lerp(before.longitude, after.longitude, fraction);
+    for (int axis = 0; axis < 3; axis++) {
+        out.velocity[axis] = lerp(before.velocity[axis], after.velocity[axis], fraction);
+    }
+    return true;
+}
@@ -0,0 +1,65 @@
+#ifndef telemetry_history_hpp
+#define telemetry_history_hpp
+
+#include <mutex>
+#include <vector>
+#include "telemetry_store.hpp"
+
+#define TELEMETRY_HISTORY_SIZE 512      // snapshots , a few seconds of the python feed or of MAVLink
+
+/**
+ * the last snapshots of the vehicle , to know its state at a time in the past (the capture time of a frame)
+ * between two snapshots the state is interpolated linearly (the yaw along the short way round) . after the newest
+ * snapshot the state is held for up to TELEMETRY_MAX_AGE , the same as a fresh snapshot of the TelemetryStore
+ * every update of the TelemetryStore is added to the history of get_instance()
+ */
+namespace VehicleModule {
+    namespace Common {
+        class TelemetryHistory {
+        public:
+            /**
+             * @return the history of the TelemetryStore
+             */
+            static TelemetryHistory& get_instance() {
+                static TelemetryHistory instance;
+                return instance;
+            }
+
+            /**
+             * @param capacity number of snapshots kept
+             */
+            TelemetryHistory(size_t capacity = TELEMETRY_HISTORY_SIZE);
+            /**
+             * @param telemetry snapshot with its timestamp , dropped if older than the newest snapshot
+             */
+            void add(const Telemetry& telemetry);
+            void clear();
+            /**
+             * @param  timestamp ms
+             * @param  out       the state at that time
+             * @return false if the history doesn't cover that time
+             */
+            bool try_get_at(long long timestamp, Telemetry& out) const;
+            /**
+             * how far the vehicle moved , from the velocity of the snapshots
+             * @param  from ms
+             * @param  to   ms
+             * @param  out  meters north east down
+             * @return false if the history doesn't cover that time
+             */
+            bool try_get_displacement(long long from, long long to, double out[3]) const;
+
+            TelemetryHistory(TelemetryHistory const&) = delete;
+            void operator=(TelemetryHistory const&) = delete;
+        private:
+            mutable std::mutex     _lock;
+            std::vector<Telemetry> _snapshots;      // ring
+            size_t                 _first, _size;
+
+            const Telemetry& _at(size_t index) const { return _snapshots[(_first + index) % _snapshots.size()]; }
+            bool _interpolate(long long timestamp, Telemetry& out) const;
+        };
+    }
+}
+
+#endif /* telemetry_history_hpp */
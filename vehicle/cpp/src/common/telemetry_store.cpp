@@ -0,0 +1,113 @@
+#include "telemetry_store.hpp"
+#include "telemetry_history.hpp"
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <sys/time.h>
+
+using namespace VehicleModule::Common;
+using namespace std;
+
+double Telemetry::get_height() const {
+    if (rangefinder > 0) {
+        return fabs(cos(fabs(pitch)) * cos(fabs(roll)) * rangefinder);
+    }
+    return altitude;
+}
+
+TelemetryStore::TelemetryStore() : _sequence(0), _next_listener_id(0) {
+    for (int i = 0; i < WORDS; i++) {
+        _words[i].store(0, memory_order_relaxed);
+    }
+}
+
+void TelemetryStore::update(const Telemetry& telemetry) {
+    Telemetry snapshot = telemetry;
+    if (!snapshot.timestamp) {
+        snapshot.timestamp = now_in_milliseconds();
+    }
+    unsigned long long words[WORDS] = {0};
+    memcpy(words, &snapshot, sizeof(Telemetry));
+    TelemetryHistory::get_instance().add(snapshot);
+
+    {
+        lock_guard<mutex> guard(_writer_lock);
+        unsigned int sequence = _sequence.load(memory_order_relaxed);
+        _sequence.store(sequence + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        for (int i = 0; i < WORDS; i++) {
+            _words[i].store(words[i], memory_order_relaxed);
+        }
+        _sequence.store(sequence + 2, memory_order_release);
+    }
+
+    lock_guard<mutex> guard(_listener_lock);
+    for (const pair<int, Listener>& listener : _listeners) {
+        listener.second(snapshot);
+    }
+}
+
+int TelemetryStore::add_listener(const Listener& listener) {
+    lock_guard<mutex> guard(_listener_lock);
+    _listeners.push_back(make_pair(_next_listener_id, listener));
+    return _next_listener_id++;
+}
+
+void TelemetryStore::remove_listener(int id) {
+    lock_guard<mutex> guard(_listener_lock);
+    for (auto itr = _listeners.begin(); itr != _listeners.end(); ++itr) {
+        if (itr->first == id) {
+            _listeners.erase(itr);
+            return;
+        }
+    }
+}
+
+void TelemetryStore::update_from_python(double roll, double pitch, double yaw, double altitude, double rangefinder,
+                                        double latitude, double longitude, double velocity_north, double velocity_east, double velocity_down) {
+    Telemetry telemetry;
+    telemetry.roll = roll;
+    telemetry.pitch = pitch;
+    telemetry.yaw = yaw;
+    telemetry.altitude = altitude;
+    telemetry.rangefinder = rangefinder;
+    telemetry.latitude = latitude;
+    telemetry.longitude = longitude;
+    telemetry.velocity[0] = velocity_north;
+    telemetry.velocity[1] = velocity_east;
+    telemetry.velocity[2] = velocity_down;
+    update(telemetry);
+}
+
+bool TelemetryStore::get(Telemetry& out) const {
+    unsigned long long words[WORDS];
+    unsigned int before, after;
+    do {
+        before = _sequence.load(memory_order_acquire);
+        if (before & 1) {
+            this_thread::yield();
+            continue;
+        }
+        for (int i = 0; i < WORDS; i++) {
+            words[i] = _words[i].load(memory_order_relaxed);
+        }
+        atomic_thread_fence(memory_order_acquire);
+        after = _sequence.load(memory_order_relaxed);
+    } while ((before & 1) || before != after);
+
+    if (!before) {
+        return false;
+    }
+    memcpy(&out, words, sizeof(Telemetry));
+    return true;
+}
+
+bool TelemetryStore::try_get_fresh(Telemetry& out, long long max_age) const {
+    return get(out) && now_in_milliseconds() - out.timestamp <= max_age;
+}
+
+long long TelemetryStore::now_in_milliseconds() {
+    struct timeval tp;
+    gettimeofday(&tp, NULL);
+    return tp.tv_sec * 1000 + tp.tv_usec / 1000;
+}
@@ -0,0 +1,101 @@
+#ifndef telemetry_store_hpp
+#define telemetry_store_hpp
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#define TELEMETRY_MAX_AGE 250           // ms , an older snapshot is not used for control
+#define TELEMETRY_UPDATE_PERIOD 50      // ms , how often the python side pushes a snapshot (see vehicle_control.py)
+
+/**
+ * the latest state of the vehicle for the C++ threads
+ * the python side (or a native feed) pushes snapshots at its own rate and any thread reads the latest one
+ * without the GIL and without a lock : the snapshot is guarded by a seqlock , a reader copies it and retries
+ * only if an update ran at the same time . updates are serialized by a mutex , they are rare next to reads
+ * every snapshot is also added to the TelemetryHistory , to know the state at the capture time of a frame
+ * and is passed to the listeners , for whoever reacts to the telemetry instead of polling it
+ */
+namespace VehicleModule {
+    namespace Common {
+
+        struct Telemetry {
+            long long timestamp;        // ms , same clock as the frame timestamps of VideoProvider , 0 if there was no update
+            double    roll, pitch, yaw; // radians
+            double    altitude;         // meters , relative to home
+            double    rangefinder;      // meters , 0 if there is no rangefinder reading
+            double    latitude, longitude;
+            double    velocity[3];      // meters per second , north east down
+
+            Telemetry() : timestamp(0), roll(0), pitch(0), yaw(0), altitude(0), rangefinder(0), latitude(0), longitude(0), velocity{0, 0, 0} {}
+            /**
+             * @return meters above the ground , from the rangefinder corrected by the attitude when there is a reading
+             */
+            double get_height() const;
+        };
+
+        class TelemetryStore {
+        public:
+            typedef std::function<void(const Telemetry&)> Listener;
+
+            static TelemetryStore& get_instance() {
+                static TelemetryStore instance;
+                return instance;
+            }
+
+            /**
+             * replace the snapshot , its timestamp is set to now if it is 0
+             */
+            void update(const Telemetry& telemetry);
+            /**
+             * the python updater , velocity is north east down
+             */
+            void update_from_python(double roll, double pitch, double yaw, double altitude, double rangefinder,
+                                    double latitude, double longitude, double velocity_north, double velocity_east, double velocity_down);
+            /**
+             * @param  out the latest snapshot
+             * @return false if there was no update yet
+             */
+            bool get(Telemetry& out) const;
+            /**
+             * @param  out     the latest snapshot
+             * @param  max_age ms
+             * @return false if there is no snapshot newer than max_age
+             */
+            bool try_get_fresh(Telemetry& out, long long max_age = TELEMETRY_MAX_AGE) const;
+            /**
+             * @return ms , the clock of the timestamps
+             */
+            static long long now_in_milliseconds();
+            /**
+             * @param  listener called on the updating thread with every snapshot , must be quick (post it somewhere)
+             * @return id for remove_listener
+             */
+            int add_listener(const Listener& listener);
+            /**
+             * the listener is not called anymore once this returns
+             */
+            void remove_listener(int id);
+
+            TelemetryStore(TelemetryStore const&) = delete;
+            void operator=(TelemetryStore const&)  = delete;
+        private:
+            enum { WORDS = (sizeof(Telemetry) + sizeof(unsigned long long) - 1) / sizeof(unsigned long long) };
+
+            // the snapshot is copied word by word through atomics so a reader that races an update reads garbage but not
+            // undefined behaviour , it then sees a different sequence and retries
+            std::atomic<unsigned long long> _words[WORDS];
+            std::atomic<unsigned int>       _sequence;     // odd while an update is running
+            std::mutex                      _writer_lock;
+            std::mutex                      _listener_lock;     // held while the listeners are called
+            std::vector<std::pair<int, Listener> > _listeners;
+            int                             _next_listener_id;
+
+            TelemetryStore();
+        };
+    }
+}
+
+#endif /* telemetry_store_hpp */
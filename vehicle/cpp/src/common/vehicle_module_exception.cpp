@@ -12,7 +12,8 @@ using namespace VehicleModule::Common;
 using namespace std;
 
 const char* VehicleModuleException::what() const throw() {
-    return (_name() + ": " + message).c_str();
+    _what = _name() + ": " + message;
+    return _what.c_str();
 }
 
 string VehicleModuleException::_name() const {
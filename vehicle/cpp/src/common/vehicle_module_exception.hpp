@@ -19,6 +19,7 @@ namespace VehicleModule {
     namespace Common {
         class VehicleModuleException : public std::exception {
         private:
+            mutable string _what;   // what returns a pointer into it
             string _name() const;
         public:
             string message;
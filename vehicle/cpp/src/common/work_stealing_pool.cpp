@@ -0,0 +1,104 @@
+#include "work_stealing_pool.hpp"
+#include <algorithm>
+
+using namespace VehicleModule::Common;
+
+// index of the worker that runs the current thread , -1 outside the pool
+static thread_local int current_worker = -1;
+static thread_local const WorkStealingPool* current_pool = nullptr;
+
+WorkStealingPool::WorkStealingPool(unsigned int num_threads)
+: _pending(0), _next_queue(0), _version(0), _stop(false) {
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned int i = 0; i < num_threads; i++) {
+        _queues.push_back(std::unique_ptr<Queue>(new Queue()));
+    }
+    for (unsigned int i = 0; i < num_threads; i++) {
+        _workers.push_back(std::thread(&WorkStealingPool::_run, this, i));
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _stop = true;
+    }
+    _work_available.notify_all();
+    for (std::thread& worker : _workers) {
+        worker.join();
+    }
+}
+
+void WorkStealingPool::submit(const Task& task) {
+    unsigned int index = current_pool == this ? static_cast<unsigned int>(current_worker)
+                                              : _next_queue++ % _queues.size();
+    _pending++;
+    {
+        std::lock_guard<std::mutex> guard(_queues[index]->lock);
+        _queues[index]->tasks.push_back(task);
+    }
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _version++;
+    }
+    _work_available.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> guard(_lock);
+    _all_done.wait(guard, [this]() { return _pending == 0; });
+}
+
+bool WorkStealingPool::_try_pop(unsigned int index, Task& task) {
+    Queue& queue = *_queues[index];
+    std::lock_guard<std::mutex> guard(queue.lock);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::_try_steal(unsigned int index, Task& task) {
+    for (unsigned int i = 1; i < _queues.size(); i++) {
+        Queue& queue = *_queues[(index + i) % _queues.size()];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::_run(unsigned int index) {
+    current_worker = static_cast<int>(index);
+    current_pool = this;
+    while (true) {
+        long long version;
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            version = _version;
+        }
+        Task task;
+        if (_try_pop(index, task) || _try_steal(index, task)) {
+            task();
+            if (--_pending == 0) {
+                std::lock_guard<std::mutex> guard(_lock);
+                _all_done.notify_all();
+            }
+            continue;
+        }
+        // nothing to take , sleep until something is submitted after we looked
+        std::unique_lock<std::mutex> guard(_lock);
+        _work_available.wait(guard, [this, version]() { return _stop || _version != version; });
+        if (_stop) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef work_stealing_pool_hpp
+#define work_stealing_pool_hpp
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * fixed number of worker threads , each with its own queue of tasks
+ * a task submitted from a worker goes to the back of the worker's own queue and the worker takes
+ * tasks from the back (the data of the last task is still in its cache) , an idle worker steals
+ * from the front of the other queues (the oldest and usually the biggest pieces of work)
+ * tasks must not block on each other (split the work into tasks that run to completion instead) and must not throw
+ */
+namespace VehicleModule {
+    namespace Common {
+        class WorkStealingPool {
+        public:
+            typedef std::function<void()> Task;
+
+            /**
+             * @param num_threads number of workers , 0 for one per core
+             */
+            WorkStealingPool(unsigned int num_threads = 0);
+            /**
+             * waits for the tasks that are already in the pool and stops the workers
+             */
+            ~WorkStealingPool();
+            /**
+             * add a task , may be called from a task
+             */
+            void submit(const Task& task);
+            /**
+             * blocks until every task (including the ones submitted by tasks) is done
+             * must not be called from a task
+             */
+            void wait();
+            unsigned int size() const { return static_cast<unsigned int>(_queues.size()); }
+
+            WorkStealingPool(WorkStealingPool const&) = delete;
+            void operator=(WorkStealingPool const&)  = delete;
+        private:
+            struct Queue {
+                std::mutex       lock;
+                std::deque<Task> tasks;
+            };
+
+            std::vector<std::unique_ptr<Queue> > _queues;
+            std::vector<std::thread>             _workers;
+            std::mutex                           _lock;
+            std::condition_variable              _work_available;
+            std::condition_variable              _all_done;
+            std::atomic<long long>               _pending;      // submitted and not done yet
+            std::atomic<unsigned int>            _next_queue;   // round robin for submits from outside the pool
+            long long                            _version;      // bumped on every submit , under _lock
+            bool                                 _stop;
+
+            void _run(unsigned int index);
+            bool _try_pop(unsigned int index, Task& task);
+            bool _try_steal(unsigned int index, Task& task);
+        };
+    }
+}
+
+#endif /* work_stealing_pool_hpp */
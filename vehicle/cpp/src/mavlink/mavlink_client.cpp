@@ -0,0 +1,234 @@
+#include "mavlink_client.hpp"
+#include <cstring>
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+
+using namespace VehicleModule::Mavlink;
+using namespace VehicleModule::Common;
+using namespace std;
+
+#define MAVLINK_MAX_DATAGRAM 2048
+
+MavlinkClient::MavlinkClient(const std::string& address, int port)
+: _running(false), _has_setpoint(false), _heartbeat_timestamp(0), _base_mode(0), _received(0), _crc_errors(0),
+  _peer_length(0), _target_system(1), _target_component(1), _encoder(MAVLINK_SYSTEM_ID, MAVLINK_COMPONENT_ID) {
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_protocol = IPPROTO_UDP;
+    struct addrinfo* addrinfo = NULL;
+    string decimal_port = to_string(port);
+    if (getaddrinfo(address.c_str(), decimal_port.c_str(), &hints, &addrinfo) != 0 || addrinfo == NULL) {
+        throw MavlinkClientException("invalid address or port for MAVLink: \"" + address + ":" + decimal_port + "\"");
+    }
+    _socket = socket(addrinfo->ai_family, SOCK_DGRAM, IPPROTO_UDP);
+    if (_socket == -1) {
+        freeaddrinfo(addrinfo);
+        throw MavlinkClientException("could not create UDP socket for MAVLink: \"" + address + ":" + decimal_port + "\"");
+    }
+    if (::bind(_socket, addrinfo->ai_addr, addrinfo->ai_addrlen) != 0) {
+        freeaddrinfo(addrinfo);
+        close(_socket);
+        throw MavlinkClientException("could not bind UDP socket for MAVLink: \"" + address + ":" + decimal_port + "\"");
+    }
+    freeaddrinfo(addrinfo);
+    memset(&_peer, 0, sizeof(_peer));
+    memset(&_setpoint, 0, sizeof(_setpoint));
+}
+
+MavlinkClient::~MavlinkClient() {
+    stop();
+    close(_socket);
+}
+
+void MavlinkClient::start() {
+    std::lock_guard<std::mutex> guard(_owner_lock);
+    if (_running) {
+        return;
+    }
+    _running = true;
+    _thread = std::thread(&MavlinkClient::_run, this);
+}
+
+void MavlinkClient::stop() {
+    std::lock_guard<std::mutex> guard(_owner_lock);
+    if (!_running) {
+        return;
+    }
+    _running = false;
+    _thread.join();
+}
+
+bool MavlinkClient::is_running() const {
+    return _running;
+}
+
+bool MavlinkClient::is_connected() const {
+    return _heartbeat_timestamp && TelemetryStore::now_in_milliseconds() - _heartbeat_timestamp < MAVLINK_HEARTBEAT_TIMEOUT;
+}
+
+bool MavlinkClient::is_armed() const {
+    return is_connected() && (_base_mode & MAV_MODE_FLAG_SAFETY_ARMED);
+}
+
+void MavlinkClient::set_velocity(double north, double east, double down) {
+    _set_velocity(north, east, down, MAV_FRAME_LOCAL_NED);
+}
+
+void MavlinkClient::set_body_velocity(double forward, double right, double down) {
+    _set_velocity(forward, right, down, MAV_FRAME_BODY_NED);
+}
+
+void MavlinkClient::set_position(double north, double east, double down) {
+    PositionTarget setpoint;
+    memset(&setpoint, 0, sizeof(setpoint));
+    setpoint.position[0] = north;
+    setpoint.position[1] = east;
+    setpoint.position[2] = down;
+    setpoint.type_mask = MAVLINK_IGNORE_VELOCITY | MAVLINK_IGNORE_ACCELERATION | MAVLINK_IGNORE_YAW;
+    setpoint.frame = MAV_FRAME_LOCAL_NED;
+    _set_setpoint(setpoint);
+}
+
+void MavlinkClient::hold() {
+    set_velocity(0, 0, 0);
+}
+
+void MavlinkClient::clear_setpoint() {
+    std::lock_guard<std::mutex> guard(_setpoint_lock);
+    _has_setpoint = false;
+}
+
+void MavlinkClient::_set_velocity(double x, double y, double z, uint8_t frame) {
+    PositionTarget setpoint;
+    memset(&setpoint, 0, sizeof(setpoint));
+    setpoint.velocity[0] = x;
+    setpoint.velocity[1] = y;
+    setpoint.velocity[2] = z;
+    setpoint.type_mask = MAVLINK_IGNORE_POSITION | MAVLINK_IGNORE_ACCELERATION | MAVLINK_IGNORE_YAW;
+    setpoint.frame = frame;
+    _set_setpoint(setpoint);
+}
+
+void MavlinkClient::_set_setpoint(const PositionTarget& setpoint) {
+    std::lock_guard<std::mutex> guard(_setpoint_lock);
+    _setpoint = setpoint;
+    _has_setpoint = true;
+}
+
+void MavlinkClient::_run() {
+    long long next_setpoint = 0, next_heartbeat = 0;
+    uint8_t datagram[MAVLINK_MAX_DATAGRAM];
+    while (_running) {
+        long long now = TelemetryStore::now_in_milliseconds();
+        if (now >= next_heartbeat) {
+            _encoder.heartbeat(_buffer);
+            _send(_buffer);
+            next_heartbeat = now + MAVLINK_HEARTBEAT_PERIOD;
+        }
+        if (now >= next_setpoint) {
+            _send_setpoint();
+            next_setpoint = now + MAVLINK_SETPOINT_PERIOD;
+        }
+
+        // wait for the vehicle till the next send
+        struct pollfd descriptor = {_socket, POLLIN, 0};
+        int timeout = static_cast<int>(max(0LL, min(next_setpoint, next_heartbeat) - now));
+        if (poll(&descriptor, 1, timeout) <= 0) {
+            continue;
+        }
+        sockaddr_storage sender;
+        socklen_t sender_length = sizeof(sender);
+        ssize_t length = recvfrom(_socket, datagram, sizeof(datagram), 0, reinterpret_cast<sockaddr*>(&sender), &sender_length);
+        if (length <= 0) {
+            continue;
+        }
+        Message message;
+        for (ssize_t i = 0; i < length; i++) {
+            if (_parser.parse(datagram[i], message)) {
+                _received++;
+                _handle(message, sender, sender_length);
+            }
+        }
+        _crc_errors = _parser.get_crc_errors();
+    }
+
+    // don't leave the vehicle flying on the last velocity
+    bool had_setpoint;
+    {
+        std::lock_guard<std::mutex> guard(_setpoint_lock);
+        had_setpoint = _has_setpoint;
+    }
+    if (had_setpoint) {
+        hold();
+        _send_setpoint();
+    }
+}
+
+void MavlinkClient::_send_setpoint() {
+    PositionTarget setpoint;
+    {
+        std::lock_guard<std::mutex> guard(_setpoint_lock);
+        if (!_has_setpoint) {
+            return;
+        }
+        setpoint = _setpoint;
+    }
+    setpoint.target_system = _target_system;
+    setpoint.target_component = _target_component;
+    _encoder.position_target(setpoint, _buffer);
+    _send(_buffer);
+}
+
+void MavlinkClient::_send(const std::vector<uint8_t>& bytes) {
+    // nothing to answer before the vehicle talked to us
+    if (!_peer_length) {
+        return;
+    }
+    sendto(_socket, bytes.data(), bytes.size(), 0, reinterpret_cast<const sockaddr*>(&_peer), _peer_length);
+}
+
+void MavlinkClient::_handle(const Message& message, const sockaddr_storage& sender, socklen_t sender_length) {
+    Heartbeat heartbeat;
+    Attitude attitude;
+    GlobalPosition position;
+    DistanceSensor distance;
+    if (decode(message, heartbeat)) {
+        // other ground stations on the link send heartbeats too
+        if (heartbeat.type == MAV_TYPE_GCS || heartbeat.autopilot == MAV_AUTOPILOT_INVALID) {
+            return;
+        }
+        // answer only the vehicle , not whoever else sends to the port
+        _peer = sender;
+        _peer_length = sender_length;
+        _target_system = message.system_id;
+        _target_component = message.component_id;
+        _base_mode = heartbeat.base_mode;
+        _heartbeat_timestamp = TelemetryStore::now_in_milliseconds();
+        return;
+    }
+    if (decode(message, attitude)) {
+        _telemetry.roll = attitude.roll;
+        _telemetry.pitch = attitude.pitch;
+        _telemetry.yaw = attitude.yaw;
+    } else if (decode(message, position)) {
+        _telemetry.latitude = position.latitude / 1e7;
+        _telemetry.longitude = position.longitude / 1e7;
+        _telemetry.altitude = position.relative_altitude / 1000.0;
+        for (int i = 0; i < 3; i++) {
+            _telemetry.velocity[i] = position.velocity[i] / 100.0;
+        }
+    } else if (decode(message, distance)) {
+        if (distance.orientation != MAVLINK_DOWNWARD_SENSOR) {
+            return;
+        }
+        bool in_range = distance.current_distance >= distance.min_distance && distance.current_distance <= distance.max_distance;
+        _telemetry.rangefinder = in_range ? distance.current_distance / 100.0 : 0;
+    } else {
+        return;
+    }
+    _telemetry.timestamp = 0;   // now
+    TelemetryStore::get_instance().update(_telemetry);
+}
@@ -0,0 +1,116 @@
+#ifndef mavlink_client_hpp
+#define mavlink_client_hpp
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include "mavlink_codec.hpp"
+#include "../common/cpp_service.hpp"
+#include "../common/telemetry_store.hpp"
+#include "../common/vehicle_module_exception.hpp"
+
+#define MAVLINK_SYSTEM_ID 255               // like a ground station
+#define MAVLINK_COMPONENT_ID 190            // MAV_COMP_ID_MISSIONPLANNER
+#define MAVLINK_SETPOINT_PERIOD 100         // ms , ArduPilot drops a guided velocity after 3 s without a new one
+#define MAVLINK_HEARTBEAT_PERIOD 1000       // ms
+#define MAVLINK_HEARTBEAT_TIMEOUT 3000      // ms , the vehicle is disconnected after this long without a heartbeat
+#define MAVLINK_DOWNWARD_SENSOR 25          // MAV_SENSOR_ROTATION_PITCH_270
+#define MAVLINK_SERVICE_NAME "mavlink"
+
+/**
+ * talks MAVLink to the autopilot over UDP from its own thread , without python
+ * listens on a local port (point an output of the autopilot or mavproxy at it) and answers the sender of the
+ * last heartbeat of the vehicle.
+ * the setpoint set by the mission is sent every MAVLINK_SETPOINT_PERIOD until it is changed or cleared , so the
+ * mission never blocks on a move . the heartbeat , attitude , position and downward rangefinder of the vehicle
+ * are parsed into the TelemetryStore
+ * published to the missions with 'publish_as_cpp_service(MAVLINK_SERVICE_NAME)'
+ */
+namespace VehicleModule {
+    namespace Mavlink {
+        class MavlinkClient : public Common::CppService {
+        public:
+            /**
+             * @param address local address to listen on ("0.0.0.0" for any)
+             * @param port    local port
+             */
+            MavlinkClient(const std::string& address, int port);
+            ~MavlinkClient();
+            /**
+             * start the thread , does nothing if already started
+             */
+            void start();
+            /**
+             * stop the thread and wait for it to exit , the vehicle is told to hold first
+             */
+            void stop();
+            bool is_running() const;
+            /**
+             * @return true if a heartbeat of the vehicle came in the last MAVLINK_HEARTBEAT_TIMEOUT
+             */
+            bool is_connected() const;
+            bool is_armed() const;
+            /**
+             * stream a velocity , meters per second north east down
+             */
+            void set_velocity(double north, double east, double down);
+            /**
+             * stream a velocity , meters per second forward right down relative to the heading of the vehicle
+             */
+            void set_body_velocity(double forward, double right, double down);
+            /**
+             * stream a position , meters north east down from the home of the vehicle
+             */
+            void set_position(double north, double east, double down);
+            /**
+             * stream zero velocity
+             */
+            void hold();
+            /**
+             * stop streaming , the autopilot falls back to its own behaviour
+             */
+            void clear_setpoint();
+            long long get_received() const { return _received; }
+            long long get_crc_errors() const { return _crc_errors; }
+
+            struct MavlinkClientException : public Common::VehicleModuleException {
+                MavlinkClientException(const string& message) : Common::VehicleModuleException(message) {}
+            };
+
+            MavlinkClient(MavlinkClient const&) = delete;
+            void operator=(MavlinkClient const&) = delete;
+        private:
+            int                     _socket;
+            std::thread             _thread;
+            std::atomic_bool        _running;
+            std::mutex              _owner_lock;            // serializes start / stop
+            std::mutex              _setpoint_lock;
+            PositionTarget          _setpoint;
+            bool                    _has_setpoint;
+            std::atomic<long long>  _heartbeat_timestamp;   // ms , of the last heartbeat of the vehicle
+            std::atomic<uint8_t>    _base_mode;
+            std::atomic<long long>  _received;
+            std::atomic<long long>  _crc_errors;
+            // used only by the thread
+            sockaddr_storage        _peer;
+            socklen_t               _peer_length;
+            uint8_t                 _target_system, _target_component;
+            Encoder                 _encoder;
+            Parser                  _parser;
+            Common::Telemetry       _telemetry;
+            std::vector<uint8_t>    _buffer;
+
+            void _run();
+            void _send_setpoint();
+            void _send(const std::vector<uint8_t>& bytes);
+            void _handle(const Message& message, const sockaddr_storage& sender, socklen_t sender_length);
+            void _set_velocity(double x, double y, double z, uint8_t frame);
+            void _set_setpoint(const PositionTarget& setpoint);
+        };
+    }
+}
+
+#endif /* mavlink_client_hpp */
@@ -0,0 +1,214 @@
+#include "mavlink_codec.hpp"
+#include <cstring>
+
+using namespace VehicleModule::Mavlink;
+using namespace std;
+
+// the crc of a message ends with a byte derived from its definition , a message we don't know can't be checked
+static bool try_get_crc_extra(uint32_t id, uint8_t& out) {
+    switch (id) {
+        case MAVLINK_MSG_HEARTBEAT:                     out = 50;  return true;
+        case MAVLINK_MSG_ATTITUDE:                      out = 39;  return true;
+        case MAVLINK_MSG_GLOBAL_POSITION_INT:           out = 104; return true;
+        case MAVLINK_MSG_SET_POSITION_TARGET_LOCAL_NED: out = 143; return true;
+        case MAVLINK_MSG_DISTANCE_SENSOR:               out = 85;  return true;
+        default:                                        return false;
+    }
+}
+
+template <typename T>
+static T get(const uint8_t* payload, int offset) {
+    T value;
+    memcpy(&value, payload + offset, sizeof(T));    // the wire and all our targets are little endian
+    return value;
+}
+
+template <typename T>
+static void put(uint8_t* payload, int offset, T value) {
+    memcpy(payload + offset, &value, sizeof(T));
+}
+
+uint16_t VehicleModule::Mavlink::crc_accumulate(uint8_t byte, uint16_t crc) {
+    uint8_t tmp = byte ^ static_cast<uint8_t>(crc & 0xFF);
+    tmp ^= (tmp << 4);
+    return (crc >> 8) ^ (static_cast<uint16_t>(tmp) << 8) ^ (static_cast<uint16_t>(tmp) << 3) ^ (tmp >> 4);
+}
+
+Encoder::Encoder(uint8_t system_id, uint8_t component_id)
+: _system_id(system_id), _component_id(component_id), _sequence(0) {}
+
+void Encoder::heartbeat(vector<uint8_t>& out) {
+    uint8_t payload[9] = {0};
+    put<uint32_t>(payload, 0, 0);
+    payload[4] = MAV_TYPE_GCS;
+    payload[5] = MAV_AUTOPILOT_INVALID;
+    payload[8] = 3;     // mavlink version
+    _frame(MAVLINK_MSG_HEARTBEAT, payload, sizeof(payload), 50, out);
+}
+
+void Encoder::position_target(const PositionTarget& target, vector<uint8_t>& out) {
+    uint8_t payload[53] = {0};
+    put<uint32_t>(payload, 0, target.time_boot_ms);
+    for (int i = 0; i < 3; i++) {
+        put<float>(payload, 4 + 4 * i, target.position[i]);
+        put<float>(payload, 16 + 4 * i, target.velocity[i]);
+        put<float>(payload, 28 + 4 * i, target.acceleration[i]);
+    }
+    put<float>(payload, 40, target.yaw);
+    put<float>(payload, 44, target.yaw_rate);
+    put<uint16_t>(payload, 48, target.type_mask);
+    payload[50] = target.target_system;
+    payload[51] = target.target_component;
+    payload[52] = target.frame;
+    _frame(MAVLINK_MSG_SET_POSITION_TARGET_LOCAL_NED, payload, sizeof(payload), 143, out);
+}
+
+void Encoder::_frame(uint8_t id, const uint8_t* payload, uint8_t length, uint8_t crc_extra, vector<uint8_t>& out) {
+    out.clear();
+    out.push_back(MAVLINK_STX_V1);
+    out.push_back(length);
+    out.push_back(_sequence++);
+    out.push_back(_system_id);
+    out.push_back(_component_id);
+    out.push_back(id);
+    out.insert(out.end(), payload, payload + length);
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 1; i < out.size(); i++) {
+        crc = crc_accumulate(out[i], crc);
+    }
+    crc = crc_accumulate(crc_extra, crc);
+    out.push_back(crc & 0xFF);
+    out.push_back(crc >> 8);
+}
+
+Parser::Parser()
+: _state(State::IDLE), _header_length(0), _header_index(0), _payload_index(0), _crc_index(0), _signature_left(0),
+  _version2(false), _crc_errors(0) {}
+
+bool Parser::parse(uint8_t byte, Message& out) {
+    switch (_state) {
+        case State::IDLE:
+            if (byte == MAVLINK_STX_V1 || byte == MAVLINK_STX_V2) {
+                _version2 = byte == MAVLINK_STX_V2;
+                // v1: length seq system component id , v2: length incompat compat seq system component id[3]
+                _header_length = _version2 ? 9 : 5;
+                _header_index = 0;
+                _state = State::HEADER;
+            }
+            return false;
+        case State::HEADER:
+            _header[_header_index++] = byte;
+            if (_header_index < _header_length) {
+                return false;
+            }
+            _message.length = _header[0];
+            if (_version2) {
+                _signature_left = (_header[1] & 0x01) ? MAVLINK_SIGNATURE_LENGTH : 0;
+                _message.sequence = _header[3];
+                _message.system_id = _header[4];
+                _message.component_id = _header[5];
+                _message.id = _header[6] | (_header[7] << 8) | (static_cast<uint32_t>(_header[8]) << 16);
+            } else {
+                _signature_left = 0;
+                _message.sequence = _header[1];
+                _message.system_id = _header[2];
+                _message.component_id = _header[3];
+                _message.id = _header[4];
+            }
+            memset(_message.payload, 0, sizeof(_message.payload));
+            _payload_index = 0;
+            _crc_index = 0;
+            _state = _message.length ? State::PAYLOAD : State::CRC;
+            return false;
+        case State::PAYLOAD:
+            _message.payload[_payload_index++] = byte;
+            if (_payload_index == _message.length) {
+                _state = State::CRC;
+            }
+            return false;
+        case State::CRC:
+            _crc[_crc_index++] = byte;
+            if (_crc_index < 2) {
+                return false;
+            }
+            _state = _signature_left ? State::SIGNATURE : State::IDLE;
+            return _finish(out);
+        case State::SIGNATURE:
+            if (--_signature_left == 0) {
+                _state = State::IDLE;
+            }
+            return false;
+    }
+    return false;
+}
+
+bool Parser::_finish(Message& out) {
+    uint8_t crc_extra;
+    if (!try_get_crc_extra(_message.id, crc_extra)) {
+        return false;
+    }
+    uint16_t crc = 0xFFFF;
+    for (int i = 0; i < _header_length; i++) {
+        crc = crc_accumulate(_header[i], crc);
+    }
+    for (int i = 0; i < _message.length; i++) {
+        crc = crc_accumulate(_message.payload[i], crc);
+    }
+    crc = crc_accumulate(crc_extra, crc);
+    if (crc != (_crc[0] | (_crc[1] << 8))) {
+        _crc_errors++;
+        return false;
+    }
+    out = _message;
+    return true;
+}
+
+bool VehicleModule::Mavlink::decode(const Message& message, Heartbeat& out) {
+    if (message.id != MAVLINK_MSG_HEARTBEAT) {
+        return false;
+    }
+    out.custom_mode = get<uint32_t>(message.payload, 0);
+    out.type = message.payload[4];
+    out.autopilot = message.payload[5];
+    out.base_mode = message.payload[6];
+    out.system_status = message.payload[7];
+    return true;
+}
+
+bool VehicleModule::Mavlink::decode(const Message& message, Attitude& out) {
+    if (message.id != MAVLINK_MSG_ATTITUDE) {
+        return false;
+    }
+    out.time_boot_ms = get<uint32_t>(message.payload, 0);
+    out.roll = get<float>(message.payload, 4);
+    out.pitch = get<float>(message.payload, 8);
+    out.yaw = get<float>(message.payload, 12);
+    return true;
+}
+
+bool VehicleModule::Mavlink::decode(const Message& message, GlobalPosition& out) {
+    if (message.id != MAVLINK_MSG_GLOBAL_POSITION_INT) {
+        return false;
+    }
+    out.time_boot_ms = get<uint32_t>(message.payload, 0);
+    out.latitude = get<int32_t>(message.payload, 4);
+    out.longitude = get<int32_t>(message.payload, 8);
+    out.altitude = get<int32_t>(message.payload, 12);
+    out.relative_altitude = get<int32_t>(message.payload, 16);
+    for (int i = 0; i < 3; i++) {
+        out.velocity[i] = get<int16_t>(message.payload, 20 + 2 * i);
+    }
+    return true;
+}
+
+bool VehicleModule::Mavlink::decode(const Message& message, DistanceSensor& out) {
+    if (message.id != MAVLINK_MSG_DISTANCE_SENSOR) {
+        return false;
+    }
+    out.time_boot_ms = get<uint32_t>(message.payload, 0);
+    out.min_distance = get<uint16_t>(message.payload, 4);
+    out.max_distance = get<uint16_t>(message.payload, 6);
+    out.current_distance = get<uint16_t>(message.payload, 8);
+    out.orientation = message.payload[12];
+    return true;
+}
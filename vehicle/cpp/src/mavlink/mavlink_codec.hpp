@@ -0,0 +1,138 @@
+#ifndef mavlink_codec_hpp
+#define mavlink_codec_hpp
+
+#include <cstdint>
+#include <vector>
+
+#define MAVLINK_STX_V1 0xFE
+#define MAVLINK_STX_V2 0xFD
+#define MAVLINK_MAX_PAYLOAD 255
+#define MAVLINK_SIGNATURE_LENGTH 13
+
+#define MAVLINK_MSG_HEARTBEAT 0
+#define MAVLINK_MSG_ATTITUDE 30
+#define MAVLINK_MSG_GLOBAL_POSITION_INT 33
+#define MAVLINK_MSG_SET_POSITION_TARGET_LOCAL_NED 84
+#define MAVLINK_MSG_DISTANCE_SENSOR 132
+
+#define MAV_TYPE_GCS 6
+#define MAV_AUTOPILOT_INVALID 8
+#define MAV_MODE_FLAG_SAFETY_ARMED 128
+#define MAV_FRAME_LOCAL_NED 1
+#define MAV_FRAME_LOCAL_OFFSET_NED 7
+#define MAV_FRAME_BODY_NED 8            // relative to the heading of the vehicle : forward right down
+
+// type_mask of SET_POSITION_TARGET_LOCAL_NED , a set bit ignores the field
+#define MAVLINK_IGNORE_POSITION 0x0007
+#define MAVLINK_IGNORE_VELOCITY 0x0038
+#define MAVLINK_IGNORE_ACCELERATION 0x01C0
+#define MAVLINK_IGNORE_YAW 0x0C00
+
+/**
+ * the few MAVLink messages the vehicle module talks , without the generated MAVLink headers
+ * messages are sent as MAVLink 1 (every autopilot accepts it) and both MAVLink 1 and 2 are parsed.
+ * the payloads are little endian with the fields sorted by size , as on the wire
+ */
+namespace VehicleModule {
+    namespace Mavlink {
+
+        struct Message {
+            uint32_t id;
+            uint8_t  system_id, component_id, sequence;
+            uint8_t  length;
+            uint8_t  payload[MAVLINK_MAX_PAYLOAD];  // zero padded , MAVLink 2 drops the trailing zeros
+        };
+
+        struct Heartbeat {
+            uint32_t custom_mode;       // the flight mode of the autopilot
+            uint8_t  type, autopilot, base_mode, system_status;
+        };
+
+        struct Attitude {
+            uint32_t time_boot_ms;
+            float    roll, pitch, yaw;  // radians
+        };
+
+        struct GlobalPosition {
+            uint32_t time_boot_ms;
+            int32_t  latitude, longitude;   // degrees * 1e7
+            int32_t  altitude;              // mm above mean sea level
+            int32_t  relative_altitude;     // mm above home
+            int16_t  velocity[3];           // cm per second , north east down
+        };
+
+        struct DistanceSensor {
+            uint32_t time_boot_ms;
+            uint16_t min_distance, max_distance, current_distance;  // cm
+            uint8_t  orientation;           // 25 is pointing down
+        };
+
+        struct PositionTarget {
+            uint32_t time_boot_ms;
+            float    position[3];           // meters , north east down
+            float    velocity[3];           // meters per second
+            float    acceleration[3];
+            float    yaw, yaw_rate;
+            uint16_t type_mask;
+            uint8_t  target_system, target_component, frame;
+        };
+
+        /**
+         * X.25 crc of MAVLink
+         */
+        uint16_t crc_accumulate(uint8_t byte, uint16_t crc);
+
+        class Encoder {
+        public:
+            /**
+             * @param system_id    of this end
+             * @param component_id of this end
+             */
+            Encoder(uint8_t system_id, uint8_t component_id);
+            void heartbeat(std::vector<uint8_t>& out);
+            void position_target(const PositionTarget& target, std::vector<uint8_t>& out);
+        private:
+            uint8_t _system_id, _component_id, _sequence;
+
+            void _frame(uint8_t id, const uint8_t* payload, uint8_t length, uint8_t crc_extra, std::vector<uint8_t>& out);
+        };
+
+        /**
+         * finds the messages in a byte stream , a message may be split between calls
+         * a bad crc or an unknown message (no crc extra) is dropped and the parser looks for the next start byte
+         */
+        class Parser {
+        public:
+            Parser();
+            /**
+             * @param  byte next byte of the stream
+             * @param  out  the message , valid only when true is returned
+             * @return true if the byte completed a message
+             */
+            bool parse(uint8_t byte, Message& out);
+            long long get_crc_errors() const { return _crc_errors; }
+        private:
+            enum class State { IDLE, HEADER, PAYLOAD, CRC, SIGNATURE };
+
+            State     _state;
+            uint8_t   _header[9];
+            int       _header_length, _header_index;
+            int       _payload_index;
+            uint8_t   _crc[2];
+            int       _crc_index;
+            int       _signature_left;
+            bool      _version2;
+            Message   _message;
+            long long _crc_errors;
+
+            bool _finish(Message& out);
+        };
+
+        bool decode(const Message& message, Heartbeat& out);
+        bool decode(const Message& message, Attitude& out);
+        bool decode(const Message& message, GlobalPosition& out);
+        bool decode(const Message& message, DistanceSensor& out);
+    }
+}
+
+#endif /* mavlink_codec_hpp */
@@ -8,24 +8,33 @@ using namespace boost;
 
 AnalyzeImageMission::AnalyzeImageMission(){
     std::cout << "mark2";
-    _add_state(State(0, "AnalyzingImage", static_cast<StateMachine::st_func>(&AnalyzeImageMission::_analyzing_image),true));
+    typedef StateTable<AnalyzeImageMission> Table;
+    typedef Table::Definition<
+        Table::States<
+            Table::Blocking<0, &AnalyzeImageMission::_analyzing_image, true>>,
+        Table::Transitions<>> Definition;
+    static const char* const descriptions[] = {"AnalyzingImage"};
+    _load<Definition>(descriptions);
 }
 
 bool AnalyzeImageMission::_analyzing_image() {
     std::cout << "mark";
     VideoProvider& video_provider = VideoProvider::get_instance();
     Modifiers::Collection collection;
-    std::shared_ptr<Modifiers::AbstractModifier> target_center_mask(new Modifiers::Mask::TargetCenter());
+    std::shared_ptr<Modifiers::Mask::TargetCenter> target_center_mask(new Modifiers::Mask::TargetCenter());
     collection.add_modifier(target_center_mask);
     video_provider.set_channel(VideoProvider::Channel::DEBUG, collection);
     cv::Mat frame;
-    cv::Point point;
+    BullseyeDetection detection;
     long long image_ts;
-    while(1){
+    while(!_is_aborted()){
         auto start = std::chrono::system_clock::now();
         if (video_provider.get_frame(frame, VideoProvider::Channel::DEFAULT, image_ts)) {
-            if (find_bullseye(frame, point)) {
-                ;
+            if (find_bullseye_dual(frame, detection)) {
+                const BullseyeResult& best = detection.target.found ? detection.target : detection.direction;
+                target_center_mask->set_target_center(best.center);
+                Common::Logger::debug("Found target " + std::to_string(detection.target.found) + " (" + std::to_string(detection.target.confidence) + ") direction "
+                                      + std::to_string(detection.direction.found) + " (" + std::to_string(detection.direction.confidence) + ")", TAG);
             }
         }
         if (!video_provider.new_frame_exist(image_ts)) {
@@ -3,6 +3,7 @@
 #define analyze_image_mission_hpp
 
 #include "state_machine.hpp"
+#include "transition_table.hpp"
 #include "../common/service_provider.hpp"
 #include "thread_locks.hpp"
 #include <thread>
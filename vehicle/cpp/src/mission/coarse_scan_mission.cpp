@@ -13,13 +13,20 @@ using namespace VehicleModule::Video;
 using namespace VehicleModule::Algorithm;
 using namespace boost;
 
-CoarseScanMission::CoarseScanMission(double altitude, double distance, double number_of_moves)
-: _altitude(altitude), _distance(distance), _number_of_moves(number_of_moves) {
-    _add_state(State(0, "Takeoff", static_cast<StateMachine::st_func>(&CoarseScanMission::_takeoff)));
-    _add_state(State(1, "Coarse Scan", static_cast<StateMachine::st_func>(&CoarseScanMission::_scan)));
-    _add_state(State(2, "Land", static_cast<StateMachine::st_func>(&CoarseScanMission::_land), true));
-    _add_transition(Transition(0, 1, static_cast<StateMachine::tr_func>(&CoarseScanMission::_should_transit)));
-    _add_transition(Transition(1, 2, static_cast<StateMachine::tr_func>(&CoarseScanMission::_should_transit)));
+CoarseScanMission::CoarseScanMission(double altitude, double distance, double number_of_moves, const std::string& detector)
+: _altitude(altitude), _distance(distance), _number_of_moves(number_of_moves), _detection_service(detector, DetectionMode::TARGET) {
+    typedef StateTable<CoarseScanMission> Table;
+    typedef Table::Definition<
+        Table::States<
+            Table::Blocking<0, &CoarseScanMission::_takeoff>,
+            Table::Blocking<1, &CoarseScanMission::_scan>,
+            Table::Blocking<2, &CoarseScanMission::_land, true>>,
+        Table::Transitions<
+            Table::Transit<0, 1, &CoarseScanMission::_should_transit>,
+            Table::Transit<1, 2, &CoarseScanMission::_should_transit>>,
+        2> Definition;
+    static const char* const descriptions[] = {"Takeoff", "Coarse Scan", "Land"};
+    _load<Definition>(descriptions);
 }
 
 bool CoarseScanMission::_takeoff() {
@@ -37,47 +44,61 @@ bool CoarseScanMission::_scan() {
     std::shared_ptr<Modifiers::Mask::TargetCenter> target_center_mask(new Modifiers::Mask::TargetCenter());
     collection.add_modifier(std::shared_ptr<Modifiers::AbstractModifier>(target_center_mask));
     VideoProvider::get_instance().set_channel(VideoProvider::Channel::DEBUG, collection);
+    _detection_service.start();
 
-    // TODO: calculate correct distance
-    int moves_left_in_direction = 1;
-    int num_moves_in_direction = 1;
-    int j = 0, x = 0, y = _distance, sign = 1;
-    while (j < _number_of_moves) {
-        int target_counter = 0;
-        for (int i=0; i < NUM_IMAGE_TO_SCAN; i++) {
-            cv::Mat frame;
-            cv::Point target_center;
-            long long image_ts;
-            if (video_provider.get_frame(frame, VideoProvider::Channel::DEFAULT, image_ts)) {
-                if (find_bullseye(frame, target_center)) {
-                    target_counter++;
-                    target_center_mask->set_target_center(target_center);
-                    Common::Logger::debug("Found target center x:" + std::to_string(target_center.x) + " y:" + std::to_string(target_center.y) ,COARSE_SCAN_MISSION);
-                }
+    // the old spiral parameters still give the size of the area , the spacing comes from the footprint
+    CoveragePlanner planner(CAMERA_FIELD_OF_VIEW, video_provider.get_width(), video_provider.get_height());
+    double radius = CoveragePlanner::get_legacy_spiral_radius(_distance / 100, (int) _number_of_moves);
+    bool continuous = ScanWhileFlying::is_available();
+    std::vector<cv::Point2d> waypoints = planner.plan(SCAN_PATTERN, _altitude, radius, continuous);
+    Common::Logger::debug("Covering " + std::to_string(2 * radius) + " meters square with " + std::to_string(waypoints.size()) + " waypoints , "
+                          + std::to_string(CoveragePlanner::get_flight_length(waypoints)) + " meters of flight" ,COARSE_SCAN_MISSION);
+
+    if (continuous) {
+        _velocity_commander.connect();
+        ScanWhileFlying scan(_detection_service, _velocity_commander, SCAN_REQUIRED_CONFIDENCE, CAMERA_FIELD_OF_VIEW);
+        bool found = scan.run(waypoints, *target_center_mask, [this]() { return _is_aborted(); });
+        VideoProvider::get_instance().clear_channel(VideoProvider::Channel::DEBUG);
+        return found;
+    }
+    // no position , stop and stare at the start and at every waypoint
+    long long last_sequence = 0;
+    Algorithm::DetectionAccumulator accumulator(SCAN_REQUIRED_CONFIDENCE);
+    cv::Point2d position(0, 0);
+    for (size_t next = 0; next <= waypoints.size() && !_is_aborted(); next++) {
+        accumulator.reset();
+        for (int i=0; i < NUM_IMAGE_TO_SCAN && !accumulator.is_hopeless(NUM_IMAGE_TO_SCAN - i); i++) {
+            Algorithm::Detection detection;
+            if (!_detection_service.wait_for_next(last_sequence, detection)) {
+                continue;
+            }
+            last_sequence = detection.sequence;
+            accumulator.add(detection.result);
+            if (detection.result.found) {
+                target_center_mask->set_target_center(detection.result.center);
+                Common::Logger::debug("Found target center x:" + std::to_string(detection.result.center.x) + " y:" + std::to_string(detection.result.center.y) ,COARSE_SCAN_MISSION);
             }
-            if (target_counter >= TARGET_THRESHOLD) {
+            if (accumulator.is_confirmed()) {
+                BullseyeResult target;
+                accumulator.get_target(target);
+                target_center_mask->set_target_center(target.center);
                 VideoProvider::get_instance().clear_channel(VideoProvider::Channel::DEBUG);
                 return true;
             }
-            if (!video_provider.new_frame_exist(image_ts)) {
-                video_provider.wait_to_next_frame();
-            }
-
         }
 
-        if (moves_left_in_direction-- == 0) {
-            num_moves_in_direction += 1 - (j % 2);
-            moves_left_in_direction = num_moves_in_direction;
-            sign = j++ % 2 == 0 ? sign : -sign;
-            int tmp = x;
-            x = abs(y) * sign;
-            y = abs(tmp) * sign;
+        if (next == waypoints.size()) {
+            break;
         }
-
+        // goto_xy is relative , in cm
+        int x = (int) round((waypoints[next].x - position.x) * 100), y = (int) round((waypoints[next].y - position.y) * 100);
+        position = waypoints[next];
         BEGIN_PYTHON_EXECUTION
         PyObject* vehicle_control = (PyObject* ) Common::ServiceProvider::get_instance().get_service("vehicle_control");
         python::call_method<void>(vehicle_control, "goto_xy", x, y);
         END_PYTHON_EXECUTION
+        // the target moved in the frame by a whole leg , the motion model can't predict that
+        _detection_service.reset();
     }
 
     VideoProvider::get_instance().clear_channel(VideoProvider::Channel::DEBUG);
@@ -85,6 +106,9 @@ bool CoarseScanMission::_scan() {
 }
 
 bool CoarseScanMission::_land() {
+    _detection_service.stop();
+    _velocity_commander.connect();
+    _velocity_commander.release();
     bool ret;
     BEGIN_PYTHON_EXECUTION
     PyObject* vehicle_control = (PyObject* ) Common::ServiceProvider::get_instance().get_service("vehicle_control");
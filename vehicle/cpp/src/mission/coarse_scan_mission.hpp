@@ -10,6 +10,7 @@
 #define coarse_scan_mission_hpp
 
 #include "state_machine.hpp"
+#include "transition_table.hpp"
 #include "../common/service_provider.hpp"
 #include "thread_locks.hpp"
 #include <thread>
@@ -21,19 +22,32 @@
 #include "../video/video_provider.hpp"
 #include <opencv2/core/mat.hpp>
 #include "../algorithm/image_algorithm.hpp"
+#include "../algorithm/detection_service.hpp"
+#include "../algorithm/detection_accumulator.hpp"
+#include "../algorithm/detector_registry.hpp"
+#include "../algorithm/ground_projection.hpp"
+#include "../algorithm/coverage_planner.hpp"
+#include "velocity_commander.hpp"
+#include "scan_while_flying.hpp"
 #include <opencv2/core/types.hpp>
 
 #define NUM_IMAGE_TO_SCAN 30
-#define TARGET_THRESHOLD 3
+#define SCAN_REQUIRED_CONFIDENCE 2.0    // accumulated detection confidence that declares a target
+#define SCAN_PATTERN Algorithm::CoveragePattern::SPIRAL    // the target is expected around the start
 #define COARSE_SCAN_MISSION "CoarseScanMission"
 
 namespace VehicleModule {
 	namespace Mission {
 		class CoarseScanMission : public StateMachine {
 		public:
-			CoarseScanMission(double altitude, double distance, double number_of_moves);
+			/**
+			 * @param detector name of the detection engine (see DetectorRegistry)
+			 */
+			CoarseScanMission(double altitude, double distance, double number_of_moves, const std::string& detector = DEFAULT_DETECTOR);
 		private:
 			double _altitude, _distance, _number_of_moves;
+			Algorithm::DetectionService _detection_service;
+			VelocityCommander           _velocity_commander;
 
 			bool    _takeoff();
 			bool    _scan();
@@ -13,11 +13,17 @@ using namespace boost;
 
 DemoMission::DemoMission(double lat, double lon, double alt)
 : _lat(lat), _lon(lon), _alt(alt) {
-    _add_state(State(0, "Takeoff", static_cast<StateMachine::st_func>(&DemoMission::_takeoff)));
-    _add_state(State(1, "Go to position", static_cast<StateMachine::st_func>(&DemoMission::_goto_position)));
-    _add_state(State(2, "Land", static_cast<StateMachine::st_func>(&DemoMission::_land), true));
-    _add_transition(Transition(0, 1, static_cast<StateMachine::tr_func>(&DemoMission::_should_transit)));
-    _add_transition(Transition(1, 2, static_cast<StateMachine::tr_func>(&DemoMission::_should_transit)));
+    typedef StateTable<DemoMission> Table;
+    typedef Table::Definition<
+        Table::States<
+            Table::Blocking<0, &DemoMission::_takeoff>,
+            Table::Blocking<1, &DemoMission::_goto_position>,
+            Table::Blocking<2, &DemoMission::_land, true>>,
+        Table::Transitions<
+            Table::Transit<0, 1, &DemoMission::_should_transit>,
+            Table::Transit<1, 2, &DemoMission::_should_transit>>> Definition;
+    static const char* const descriptions[] = {"Takeoff", "Go to position", "Land"};
+    _load<Definition>(descriptions);
 }
 
 bool DemoMission::_takeoff() {
@@ -10,6 +10,7 @@
 #define demo_mission_hpp
 
 #include "state_machine.hpp"
+#include "transition_table.hpp"
 #include "../common/service_provider.hpp"
 #include "thread_locks.hpp"
 #include <thread>
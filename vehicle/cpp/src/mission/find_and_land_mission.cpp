@@ -11,27 +11,58 @@ using namespace boost;
 #define WAIT_TO_VIDEOPROVIDER 500
 #define CONTROL_LOOP_TIMEOUT 10000
 #define HEIGHT_THRESHOLD 1
-#define MAX_HISTORY_SIZE 15
 #define NUMBER_OF_RETRIES 3
 #define DISTANCE_FROM_CENTER_THRESHOLD 50
+#define DESCENT_STEP 0.5                // meters , lower the required height by this much at a time
+#define DESCENT_STEP_REACHED 0.15       // meters , a step is reached once the vehicle is this close above it
+#define DESCENT_FLOOR 0.5               // meters , below HEIGHT_THRESHOLD so the last step ends the descent
 #define K 1
 #define TAU_1 20
 #define TAU_2 20
-#define Alpha (45 / (double) 360) * 2 * M_PI
+#define KI (K / (double) TAU_1)
+#define KD (K / (double) TAU_2)
+#define CONTROL_MAX_SPEED 1             // m/s , the fast speed of goto_xyz
+#define CONTROL_MAX_VERTICAL_SPEED 0.5  // m/s
+#define CONTROL_TARGET_MAX_AGE 500      // ms , the vehicle holds when the last detection is older
+#define Alpha CAMERA_FIELD_OF_VIEW
+#define LEVEL_ANGLE 0.25                // radians , the altitude is accurate only while the vehicle tilts less
+#define TARGET_RING_SPACING 0.1     // meters , must match the printed target
+#define TARGET_NUM_RINGS 5
 
-typedef arma::vec TargetError;
-typedef arma::vec Location;
-typedef deque<TargetError> ErrorsHistory;
+// same clock as the frame timestamps of VideoProvider
+static long long now_in_milliseconds() {
+    struct timeval tp;
+    gettimeofday(&tp, NULL);
+    return tp.tv_sec * 1000 + tp.tv_usec / 1000;
+}
+
+FindAndLandMission::FindAndLandMission(double altitude, double distance, double number_of_moves, const std::string& detector, double control_rate)
+: _altitude(altitude), _distance(distance), _number_of_moves(number_of_moves), _detection_service(detector, DetectionMode::DIRECTION),
+  _altitude_estimator(TARGET_RING_SPACING, TARGET_NUM_RINGS, Alpha), _control_loop(control_rate),
+  _pid_x(K, KI, KD, CONTROL_MAX_SPEED), _pid_y(K, KI, KD, CONTROL_MAX_SPEED), _pid_z(K, KI, KD, CONTROL_MAX_VERTICAL_SPEED),
+  _target_predictor(Common::TelemetryHistory::get_instance()), _control_output{0, 0, 0} {
+    typedef StateTable<FindAndLandMission> Table;
+    typedef Table::Definition<
+        Table::States<
+            Table::Blocking<0, &FindAndLandMission::_takeoff>,
+            Table::Blocking<1, &FindAndLandMission::_scan>,
+            Table::Blocking<2, &FindAndLandMission::_fine_scan>,
+            Table::Blocking<3, &FindAndLandMission::_land, true>>,
+        Table::Transitions<
+            Table::Transit<0, 1, &FindAndLandMission::_should_transit>,
+            Table::Transit<1, 2, &FindAndLandMission::_should_transit>,
+            Table::Transit<2, 3, &FindAndLandMission::_should_transit>>,
+        3> Definition;
+    static const char* const descriptions[] = {"Takeoff", "Coarse Scan", "Fine Scan", "Land"};
+    _load<Definition>(descriptions);
 
-FindAndLandMission::FindAndLandMission(double altitude, double distance, double number_of_moves)
-: _altitude(altitude), _distance(distance), _number_of_moves(number_of_moves) {
-    _add_state(State(0, "Takeoff", static_cast<StateMachine::st_func>(&FindAndLandMission::_takeoff)));
-    _add_state(State(1, "Coarse Scan", static_cast<StateMachine::st_func>(&FindAndLandMission::_scan)));
-    _add_state(State(2, "Fine Scan", static_cast<StateMachine::st_func>(&FindAndLandMission::_fine_scan)));
-    _add_state(State(3, "Land", static_cast<StateMachine::st_func>(&FindAndLandMission::_land), true));
-    _add_transition(Transition(0, 1, static_cast<StateMachine::tr_func>(&FindAndLandMission::_should_transit)));
-    _add_transition(Transition(1, 2, static_cast<StateMachine::tr_func>(&FindAndLandMission::_should_transit)));
-    _add_transition(Transition(2, 3, static_cast<StateMachine::tr_func>(&FindAndLandMission::_should_transit)));
+    // looks at the frames next to the states that move the vehicle , for the whole mission
+    typedef Table::Definition<
+        Table::States<
+            Table::Reacting<0, &FindAndLandMission::_watch_detections, true>>,
+        Table::Transitions<>> DetectionDefinition;
+    static const char* const detection_descriptions[] = {"Watching"};
+    _load<DetectionDefinition>(detection_descriptions, _add_region(DETECTION_REGION_TAG));
 }
 
 bool FindAndLandMission::_takeoff()
@@ -52,102 +83,159 @@ bool FindAndLandMission::_scan()
     std::shared_ptr<Modifiers::Mask::TargetCenter> target_center_mask(new Modifiers::Mask::TargetCenter());
     collection.add_modifier(std::shared_ptr<Modifiers::AbstractModifier>(target_center_mask));
     video_provider.set_channel(VideoProvider::Channel::DEBUG, collection);
+    _detection_service.start();
 
-    // TODO: calculate correct distance
-    int distance = 100; // cm
-    int moves_left_in_direction = 1;
-    int num_moves_in_direction = 1;
-    int j = 0, x = 0, y = distance, sign = 1;
-    while (j < 20) {
-        int target_counter = 0;
-        Common::Logger::debug("Start scanning ..." ,FIND_AND_LAND_TAG);
+    // the old spiral parameters still give the size of the area , the spacing comes from the footprint
+    CoveragePlanner planner(Alpha, video_provider.get_width(), video_provider.get_height());
+    double radius = CoveragePlanner::get_legacy_spiral_radius(_distance / 100, (int) _number_of_moves);
+    bool continuous = ScanWhileFlying::is_available();
+    std::vector<cv::Point2d> waypoints = planner.plan(SCAN_PATTERN, _altitude, radius, continuous);
+    Common::Logger::debug("Covering " + std::to_string(2 * radius) + " meters square with " + std::to_string(waypoints.size()) + " waypoints , "
+                          + std::to_string(CoveragePlanner::get_flight_length(waypoints)) + " meters of flight" ,FIND_AND_LAND_TAG);
 
-        for (int i=0; i < NUM_IMAGE_TO_SCAN; i++) {
-            cv::Mat frame;
-            cv::Point target_center;
-            long long image_ts;
-            if (video_provider.get_frame(frame, VideoProvider::Channel::DEFAULT, image_ts)) {
-                if (find_bullseye_direction(frame, target_center)) {
-                    target_counter++;
-                    target_center_mask->set_target_center(target_center);
-                    Common::Logger::debug("Found target center x:" + std::to_string(target_center.x) + " y:" + std::to_string(target_center.y) ,FIND_AND_LAND_TAG);
-                }
-            }
-            if (target_counter >= TARGET_THRESHOLD) {
-                VideoProvider::get_instance().clear_channel(VideoProvider::Channel::DEBUG);
-                return true;
-            }
-            if (!video_provider.new_frame_exist(image_ts)) {
-                video_provider.wait_to_next_frame();
-            }
+    if (continuous) {
+        _velocity_commander.connect();
+        ScanWhileFlying scan(_detection_service, _velocity_commander, SCAN_REQUIRED_CONFIDENCE, Alpha);
+        bool found = scan.run(waypoints, *target_center_mask, [this]() { return _is_aborted(); });
+        VideoProvider::get_instance().clear_channel(VideoProvider::Channel::DEBUG);
+        return found;
+    }
+    // no position , stop and stare at the start and at every waypoint
+    // the detection region looks at the frames (see _watch_detections) , this state moves the vehicle and asks it
+    {
+        std::lock_guard<std::mutex> guard(_watch_lock);
+        _watch.mask = target_center_mask;
+    }
+    bool found = false;
+    cv::Point2d position(0, 0);
+    for (size_t next = 0; next <= waypoints.size() && !_is_aborted(); next++) {
+        Common::Logger::debug("Start scanning ..." ,FIND_AND_LAND_TAG);
+        double evidence;
+        if (_look(evidence)) {
+            found = true;
+            break;
         }
-        Common::Logger::debug("Did not found enough frames with target . required : " + std::to_string(TARGET_THRESHOLD) + " found : " + std::to_string(target_counter),FIND_AND_LAND_TAG);
+        Common::Logger::debug("Did not found enough evidence of a target . required : " + std::to_string(SCAN_REQUIRED_CONFIDENCE) + " found : " + std::to_string(evidence),FIND_AND_LAND_TAG);
 
-        if (moves_left_in_direction-- == 0) {
-            num_moves_in_direction += 1 - (j % 2);
-            moves_left_in_direction = num_moves_in_direction;
-            sign = j++ % 2 == 0 ? sign : -sign;
-            int tmp = x;
-            x = abs(y) * sign;
-            y = abs(tmp) * sign;
+        if (next == waypoints.size()) {
+            break;
         }
-        Common::Logger::debug("Moving drone to x:" + std::to_string(x) + ", y:" + std::to_string(y) + " moves left to that direction is " + std::to_string(moves_left_in_direction) ,FIND_AND_LAND_TAG);
+        // goto_xy is relative , in cm
+        int x = (int) round((waypoints[next].x - position.x) * 100), y = (int) round((waypoints[next].y - position.y) * 100);
+        position = waypoints[next];
+        Common::Logger::debug("Moving drone to x:" + std::to_string(x) + ", y:" + std::to_string(y) + " waypoints left " + std::to_string(waypoints.size() - next - 1) ,FIND_AND_LAND_TAG);
         BEGIN_PYTHON_EXECUTION
         PyObject* vehicle_control = (PyObject* ) Common::ServiceProvider::get_instance().get_service("vehicle_control");
         python::call_method<void>(vehicle_control, "goto_xy", x, y);
         END_PYTHON_EXECUTION
+        // the target moved in the frame by a whole leg , the motion model can't predict that
+        _detection_service.reset();
     }
 
+    {
+        std::lock_guard<std::mutex> guard(_watch_lock);
+        _watch.mask.reset();
+    }
     VideoProvider::get_instance().clear_channel(VideoProvider::Channel::DEBUG);
-    return false;
+    return found;
 }
 
-static TargetError integral(const ErrorsHistory & errors_history){
-    Location out(3);
-    out[0] = out[1] = out[2] = 0;
-    double factor = 2;
-    int size = errors_history.size();
-    if(size > 2){
-        for(auto err : errors_history ){
-            out += err / factor;
-            factor *= factor;
-        }
+// one look of the detection region at the current waypoint , as long as NUM_IMAGE_TO_SCAN frames used to take
+bool FindAndLandMission::_look(double& evidence) {
+    std::unique_lock<std::mutex> guard(_watch_lock);
+    long long round = _watch.round + 1;
+    guard.unlock();
+    _signal(WATCH_LOOK_SIGNAL);
+    guard.lock();
+
+    steady_clock::time_point deadline = steady_clock::now() + milliseconds(NUM_IMAGE_TO_SCAN * DETECTION_SERVICE_WAIT_TIMEOUT);
+    auto done = [this, round]() {
+        return _watch.round == round && (_watch.accumulator.is_confirmed() || _watch.frames >= NUM_IMAGE_TO_SCAN
+                                         || _watch.accumulator.is_hopeless(NUM_IMAGE_TO_SCAN - _watch.frames));
+    };
+    while (!done() && !_is_aborted() && steady_clock::now() < deadline) {
+        _watch_changed.wait_for(guard, milliseconds(WATCH_POLL_PERIOD));
     }
-    return out;
+    bool confirmed = _watch.round == round && _watch.accumulator.is_confirmed();
+    evidence = _watch.round == round ? _watch.accumulator.get_evidence() : 0;
+    guard.unlock();
+    _signal(WATCH_MOVE_SIGNAL);
+    return confirmed;
 }
 
-static TargetError derivative(const ErrorsHistory & errors_history){
-    Location out(3);
-    out[0] = out[1] = out[2] = 0;
-    double factor = 2;
-    int size = errors_history.size() ;
-    if(size > 2){
-        for(int i = 0 ; i < (size - 1) ; ++i){
-            Location err = errors_history[i];
-            Location prv_err = errors_history[i+1];
-            out += (prv_err - err) / factor;
-            factor *= factor;
+StateMachine::StepResult FindAndLandMission::_watch_detections(const Event& event) {
+    switch (event.type) {
+        case EventType::ENTER:
+            _listen_to(_detection_service);
+            return StepResult::STAY;
+        case EventType::SIGNAL: {
+            std::lock_guard<std::mutex> guard(_watch_lock);
+            _watch.looking = event.id == WATCH_LOOK_SIGNAL;
+            if (_watch.looking) {
+                _watch.round++;
+                _watch.frames = 0;
+                _watch.accumulator.reset();
+            }
+            break;
         }
+        case EventType::FRAME_READY: {
+            const BullseyeResult& result = event.detection.result;
+            {
+                std::lock_guard<std::mutex> guard(_watch_lock);
+                if (!_watch.looking) {
+                    return StepResult::STAY;
+                }
+                _watch.frames++;
+                _watch.accumulator.add(result);
+                BullseyeResult target;
+                if (_watch.accumulator.is_confirmed() && _watch.accumulator.get_target(target)) {
+                    if (_watch.mask) {
+                        _watch.mask->set_target_center(target.center);
+                    }
+                } else if (result.found && _watch.mask) {
+                    _watch.mask->set_target_center(result.center);
+                }
+            }
+            if (result.found) {
+                Common::Logger::debug("Found target center x:" + std::to_string(result.center.x) + " y:" + std::to_string(result.center.y) ,DETECTION_REGION_TAG);
+            }
+            break;
+        }
+        default:
+            return StepResult::STAY;
     }
-    return out;
-}
-
-static double pixel2meter(int pixels, double height, int frame_width){
-    return pixels * 2 * height * tan(0.5 * Alpha) / (double) frame_width;
+    _watch_changed.notify_all();
+    return StepResult::STAY;
 }
 
 static int meter2pixel(double meter, double height, int frame_width){
     return meter * frame_width / (2 * height * tan(0.5 * Alpha));
 }
 
+// the altitude is accurate only while the vehicle is about level
+// read from the TelemetryStore while it is fed , else from the vehicle through python
 bool FindAndLandMission::_try_get_accurate_altitude(double & out){
     int number_of_retries = 0;
+    Common::Telemetry telemetry;
+    if(Common::TelemetryStore::get_instance().try_get_fresh(telemetry)){
+        while(abs(telemetry.roll) > LEVEL_ANGLE || abs(telemetry.pitch) > LEVEL_ANGLE){
+            if(++number_of_retries == NUM_OF_RETRIES){
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(TELEMETRY_UPDATE_PERIOD));
+            if(!Common::TelemetryStore::get_instance().try_get_fresh(telemetry)){
+                return false;
+            }
+        }
+        out = telemetry.get_height();
+        return true;
+    }
     PyObject* vehicle_control = (PyObject* ) Common::ServiceProvider::get_instance().get_service("vehicle_control");
     BEGIN_PYTHON_EXECUTION
     while(number_of_retries < NUM_OF_RETRIES){
-        double roll_angle = python::call_method<double>(vehicle_control, "get_altitude");
-        double pitch_angle = python::call_method<double>(vehicle_control, "get_altitude");
-        if(abs(roll_angle) > 0.25 || abs(pitch_angle) > 0.25){
+        double roll_angle = python::call_method<double>(vehicle_control, "get_roll_angle");
+        double pitch_angle = python::call_method<double>(vehicle_control, "get_pitch_angle");
+        if(abs(roll_angle) > LEVEL_ANGLE || abs(pitch_angle) > LEVEL_ANGLE){
             number_of_retries++;
         }else{
             break;
@@ -155,7 +243,24 @@ bool FindAndLandMission::_try_get_accurate_altitude(double & out){
     }
     out = python::call_method<double>(vehicle_control, "get_altitude");
     END_PYTHON_EXECUTION
-    return (number_of_retries == NUM_OF_RETRIES);
+    return (number_of_retries < NUM_OF_RETRIES);
+}
+
+// the fused altitude , the vehicle is asked only when the estimate is too old or too uncertain
+bool FindAndLandMission::_try_get_altitude(double & out){
+    if(_altitude_estimator.needs_telemetry(now_in_milliseconds())){
+        int number_of_retries = 0;
+        double altitude = 0;
+        while(!_try_get_accurate_altitude(altitude) && number_of_retries < NUM_OF_RETRIES){
+            number_of_retries++;
+        }
+        if(number_of_retries == NUM_OF_RETRIES){
+            return false;
+        }
+        _altitude_estimator.add_telemetry(altitude, now_in_milliseconds());
+    }
+    out = _altitude_estimator.get_altitude();
+    return true;
 }
 
 bool FindAndLandMission::_fine_scan(){
@@ -177,103 +282,152 @@ bool FindAndLandMission::_fine_scan(){
         Common::Logger::debug("Can get frame width or frame height",FIND_AND_LAND_TAG);
         return false;
     }
-    int number_of_retries = 0;
-    PyObject* vehicle_control = (PyObject* ) Common::ServiceProvider::get_instance().get_service("vehicle_control");
-    arma::vec required_position(3);
-    while(!_try_get_accurate_altitude(required_position[2]) && number_of_retries < NUM_OF_RETRIES){
-        number_of_retries++;
-    }
-    if(number_of_retries == NUM_OF_RETRIES){
+    double required_height;
+    _altitude_estimator.reset();
+    if(!_try_get_altitude(required_height)){
         VideoProvider::get_instance().clear_channel(VideoProvider::Channel::DEBUG);
         Common::Logger::debug("Can not get accurate altitude",FIND_AND_LAND_TAG);
         return false;
     }
-    number_of_retries = 0;
-    required_position[0] = frame_width / 2;
-    required_position[1] = frame_height / 2;
-    ErrorsHistory errors;
+    _detection_service.start();
+
+    // the controller runs on its own thread at a fixed rate , this thread only feeds it the target
+    {
+        std::lock_guard<std::mutex> guard(_control_lock);
+        _control_target = ControlTarget();
+    }
+    _velocity_commander.connect();
+    _control_loop.start(std::bind(&FindAndLandMission::_control, this, std::placeholders::_1));
+    bool ret = _descend(required_height, frame_width, frame_height, *target_center_mask, *direction_vector_mask);
+    _control_loop.stop();
+    _velocity_commander.hold();
+
+    Common::LoopStatistics statistics = _control_loop.get_statistics();
+    Common::Logger::debug("Control loop at " + std::to_string(_control_loop.get_rate()) + " Hz , iterations " + std::to_string(statistics.iterations)
+                          + " deadline misses " + std::to_string(statistics.deadline_misses) + " jitter mean " + std::to_string(statistics.mean_jitter)
+                          + " us max " + std::to_string(statistics.max_jitter) + " us",FIND_AND_LAND_TAG);
+    VideoProvider::get_instance().clear_channel(VideoProvider::Channel::DEBUG);
+    return ret;
+}
+
+bool FindAndLandMission::_descend(double required_height, int frame_width, int frame_height,
+                                  Modifiers::Mask::TargetCenter& target_center_mask, Modifiers::Mask::DirectionVector& direction_vector_mask){
+    int number_of_retries = 0;
+    long long last_sequence = 0;
     double current_height = 0;
     auto controller_start_time = std::chrono::high_resolution_clock::now();
     cv::Point from(frame_width / 2, frame_height / 2);
-    while(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - controller_start_time).count() < CONTROL_LOOP_TIMEOUT){
-        while(!_try_get_accurate_altitude(current_height) && number_of_retries < NUM_OF_RETRIES){
-            number_of_retries++;
-        }
-        if(number_of_retries == NUM_OF_RETRIES){
-            VideoProvider::get_instance().clear_channel(VideoProvider::Channel::DEBUG);
+    while(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - controller_start_time).count() < CONTROL_LOOP_TIMEOUT
+          && !_is_aborted()){
+        if(!_try_get_altitude(current_height)){
             Common::Logger::debug("Can not get accurate altitude when trying to find if the vehicle at required height",FIND_AND_LAND_TAG);
             return false;
         }
         if(current_height < HEIGHT_THRESHOLD){
-            VideoProvider::get_instance().clear_channel(VideoProvider::Channel::DEBUG);
             Common::Logger::debug("Reached required height , current height is " + std::to_string(current_height),FIND_AND_LAND_TAG);
             return true;
         }
         number_of_retries = 0;
         Common::Logger::debug("Trying to reach desiried height , current height is " + std::to_string(current_height),FIND_AND_LAND_TAG);
 
-        long long image_timestamp;
-        cv::Mat frame;
-        cv::Point target_center;
-        while(!video_provider.get_frame(frame, VideoProvider::Channel::DEFAULT, image_timestamp) || !find_bullseye_direction(frame,target_center)){
+        // the detection service keeps processing frames while we talk to the vehicle , take the first result we didn't use yet
+        Algorithm::Detection detection;
+        while(!_detection_service.wait_for_next(last_sequence, detection) || !detection.result.found){
+            last_sequence = detection.sequence;
             if(number_of_retries++ == NUM_OF_RETRIES){
-                VideoProvider::get_instance().clear_channel(VideoProvider::Channel::DEBUG);
                 Common::Logger::debug("Can not find target in the picture",FIND_AND_LAND_TAG);
                 return false;
             }
-            video_provider.wait_to_next_frame();
         }
+        last_sequence = detection.sequence;
+        cv::Point target_center = detection.result.center;
         Common::Logger::debug("Found target center x:" + std::to_string(target_center.x) + " y:" + std::to_string(target_center.y) ,FIND_AND_LAND_TAG);
-        target_center_mask->set_target_center(target_center);
-        number_of_retries = 0;
-        arma::vec error(3);
-        error[0] = pixel2meter((target_center.x  -  required_position[0]), current_height, frame_width);
-        error[1] = pixel2meter((target_center.y  -  required_position[1]), current_height, frame_width);
-        error[1] = -error[1];
-        auto x_value = error[0];
-        error[0] = error[1];
-        error[1] = -x_value;
-        int a = target_center.x  -  required_position[0];
-        int b = target_center.y  -  required_position[1];
+        target_center_mask.set_target_center(target_center);
+        // the height of the vehicle when the frame was captured , the estimator doesn't need to ask the vehicle while it comes
+        const Common::Telemetry& frame_telemetry = detection.telemetry;
+        if(detection.has_telemetry && abs(frame_telemetry.roll) < LEVEL_ANGLE && abs(frame_telemetry.pitch) < LEVEL_ANGLE){
+            _altitude_estimator.add_telemetry(frame_telemetry.get_height(), detection.timestamp);
+        }
+        if(_altitude_estimator.add_vision(detection.result, frame_width, detection.timestamp)){
+            Common::Logger::debug("Altitude from the target size " + std::to_string(_altitude_estimator.get_altitude()) + " +- " + std::to_string(_altitude_estimator.get_sigma(detection.timestamp)),FIND_AND_LAND_TAG);
+        }
+        // the geometry of the frame is at its capture time
+        current_height = _altitude_estimator.get_altitude();
+        int a = target_center.x  -  frame_width / 2;
+        int b = target_center.y  -  frame_height / 2;
         double distance_from_center = sqrt(a*a + b*b);
+        // detections come many times a second , step down only once the last step was reached
         if(distance_from_center < DISTANCE_FROM_CENTER_THRESHOLD){
-            required_position[2] -= 0.5;
-            errors.clear();
-            Common::Logger::debug("Target center is close enough , lowering height from " + std::to_string(current_height) + "to " + std::to_string(required_position[2]),FIND_AND_LAND_TAG);
+            if(current_height - required_height < DESCENT_STEP_REACHED){
+                required_height = std::max(current_height - DESCENT_STEP, DESCENT_FLOOR);
+                Common::Logger::debug("Target center is close enough , lowering height from " + std::to_string(current_height) + "to " + std::to_string(required_height),FIND_AND_LAND_TAG);
+            }
         }else{
+            // stop going down while the target is off center
+            required_height = std::max(required_height, current_height);
             Common::Logger::debug("distance from center in px is " + std::to_string(distance_from_center) + "required  distance is " + std::to_string(DISTANCE_FROM_CENTER_THRESHOLD),FIND_AND_LAND_TAG);
         }
-        while(!_try_get_accurate_altitude(current_height) && number_of_retries < NUM_OF_RETRIES){
-            number_of_retries++;
+
+        ControlTarget target;
+        target.timestamp = detection.timestamp;
+        frame_to_body(target_center, frame_width, frame_height, current_height, Alpha, target.error[0], target.error[1]);
+        target.height = current_height;
+        target.required_height = required_height;
+        double output[3];
+        {
+            std::lock_guard<std::mutex> guard(_control_lock);
+            _control_target = target;
+            std::copy(_control_output, _control_output + 3, output);
         }
-        if(number_of_retries == NUM_OF_RETRIES){
-            VideoProvider::get_instance().clear_channel(VideoProvider::Channel::DEBUG);
-            Common::Logger::debug("Can not get accurate altitude when trying to estimate the error",FIND_AND_LAND_TAG);
+        // the control thread can't log , its failed sends are reported here
+        std::string error;
+        int failures = _velocity_commander.take_failures(error);
+        if(failures){
+            Common::Logger::warn("Could not send " + std::to_string(failures) + " velocities : " + error,FIND_AND_LAND_TAG);
             return false;
         }
-        number_of_retries = 0;
-        error[2] = required_position[2] - current_height;
-        if(errors.size() > MAX_HISTORY_SIZE){
-            errors.pop_back();
-        }
-        errors.push_front(error);
-        arma::vec output =  K * error + (K/TAU_1) * integral(errors) + (K/TAU_2) * derivative(errors);
+        // the velocity the controller is sending , as the move it makes in a second
         cv::Point to(meter2pixel(output[0], current_height, frame_width) + frame_width/2,
                     -meter2pixel(output[1], current_height, frame_width) + frame_height/2);
-        direction_vector_mask->set_direction_vector(from,to);
-        output *= 100;
-        BEGIN_PYTHON_EXECUTION
-        python::call_method<void>(vehicle_control, "goto_xyz", output[0], output[1],output[2]);
-        END_PYTHON_EXECUTION
-        if (!video_provider.new_frame_exist(image_timestamp)) {
-            video_provider.wait_to_next_frame();
-        }
+        direction_vector_mask.set_direction_vector(from,to);
     }
-    VideoProvider::get_instance().clear_channel(VideoProvider::Channel::DEBUG);
     return false;
 }
 
+// an iteration of the control thread , must not throw or talk to the Logger (python)
+void FindAndLandMission::_control(double time){
+    ControlTarget target;
+    {
+        std::lock_guard<std::mutex> guard(_control_lock);
+        target = _control_target;
+    }
+    long long now = now_in_milliseconds();
+    if(!target.timestamp || now - target.timestamp > CONTROL_TARGET_MAX_AGE){
+        _pid_x.reset();
+        _pid_y.reset();
+        _pid_z.reset();
+        _velocity_commander.hold();
+        return;
+    }
+    // the height from the vehicle is newer than the one of the last detection when it is fed
+    Common::Telemetry telemetry;
+    double height = Common::TelemetryStore::get_instance().try_get_fresh(telemetry) ? telemetry.get_height() : target.height;
+    // the frame is old by the time it is detected , act on where the target is now
+    double right, forward;
+    _target_predictor.predict(target.error[0], target.error[1], target.height, target.timestamp, now, right, forward);
+    double output[3] = {_pid_x.update(right, time), _pid_y.update(forward, time),
+                        _pid_z.update(target.required_height - height, time)};
+    {
+        std::lock_guard<std::mutex> guard(_control_lock);
+        std::copy(output, output + 3, _control_output);
+    }
+    _velocity_commander.send(output[1], output[0], -output[2]);
+}
+
 bool FindAndLandMission::_land() {
+    _detection_service.stop();
+    _velocity_commander.connect();
+    _velocity_commander.release();
     bool ret;
     BEGIN_PYTHON_EXECUTION
     PyObject* vehicle_control = (PyObject* ) Common::ServiceProvider::get_instance().get_service("vehicle_control");
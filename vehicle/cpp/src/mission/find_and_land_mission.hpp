@@ -10,8 +10,10 @@
 #define find_and_land_mission_hpp
 
 #include "state_machine.hpp"
+#include "transition_table.hpp"
 #include "../common/service_provider.hpp"
 #include "../common/logger.hpp"
+#include "../common/telemetry_store.hpp"
 #include "thread_locks.hpp"
 #include <thread>
 #include <iostream>
@@ -24,29 +26,92 @@
 #include <opencv2/core/mat.hpp>
 #include <opencv2/core/types.hpp>
 #include "../algorithm/image_algorithm.hpp"
+#include "../algorithm/detection_service.hpp"
+#include "../algorithm/detection_accumulator.hpp"
+#include "../algorithm/detector_registry.hpp"
+#include "../algorithm/altitude_estimator.hpp"
+#include "../algorithm/pid_controller.hpp"
+#include "../algorithm/target_predictor.hpp"
+#include "../algorithm/ground_projection.hpp"
+#include "../algorithm/coverage_planner.hpp"
+#include "../common/fixed_rate_loop.hpp"
+#include "velocity_commander.hpp"
+#include "scan_while_flying.hpp"
+#include <mutex>
+#include <condition_variable>
 #include<math.h>
 #include <opencv2/core/types.hpp>
 #include <string>
 
 #define NUM_IMAGE_TO_SCAN 30
-#define TARGET_THRESHOLD 3
+#define SCAN_REQUIRED_CONFIDENCE 2.0    // accumulated detection confidence that declares a target
+#define SCAN_PATTERN Algorithm::CoveragePattern::SPIRAL    // the target is expected around the start
+#define FINE_SCAN_CONTROL_RATE 30       // Hz , of the controller during the fine scan
+#define WATCH_LOOK_SIGNAL 1             // to the detection region , start a new look at the current waypoint
+#define WATCH_MOVE_SIGNAL 2             // to the detection region , the vehicle moves , the frames don't count
+#define WATCH_POLL_PERIOD 100           // ms , how often a wait for the detection region checks for an abort
 #define FIND_AND_LAND_TAG "FindAndLandMission"
+#define DETECTION_REGION_TAG "FindAndLandDetection"
 
 namespace VehicleModule {
 	namespace Mission {
 		class FindAndLandMission : public StateMachine {
 		public:
-			FindAndLandMission(double altitude, double distance, double number_of_moves);
+			/**
+			 * @param detector     name of the detection engine (see DetectorRegistry)
+			 * @param control_rate Hz , of the controller during the fine scan
+			 */
+			FindAndLandMission(double altitude, double distance, double number_of_moves, const std::string& detector = DEFAULT_DETECTOR,
+			                   double control_rate = FINE_SCAN_CONTROL_RATE);
 		private:
+			// what the fine scan knows about the target , handed to the control thread
+			struct ControlTarget {
+				long long timestamp;        // ms , capture time of the frame , 0 if there is no target
+				double    error[2];         // meters , offset of the target in the frame , right and forward
+				double    height;           // meters , when the frame was captured
+				double    required_height;  // meters
+
+				ControlTarget() : timestamp(0), error{0, 0}, height(0), required_height(0) {}
+			};
+
+			// what the detection region found in the current look , shared with the coarse scan
+			struct Watch {
+				long long                       round;      // looks started so far
+				bool                            looking;
+				int                             frames;     // of the current look
+				Algorithm::DetectionAccumulator accumulator;
+				std::shared_ptr<Video::Modifiers::Mask::TargetCenter> mask;   // shows the hits , may be null
+
+				Watch() : round(0), looking(false), frames(0), accumulator(SCAN_REQUIRED_CONFIDENCE) {}
+			};
+
 			double _altitude, _distance, _number_of_moves;
+			Algorithm::DetectionService _detection_service;
+			Algorithm::AltitudeEstimator _altitude_estimator;
+			Common::FixedRateLoop _control_loop;
+			Algorithm::PidController _pid_x, _pid_y, _pid_z;   // used only by the control thread
+			Algorithm::TargetPredictor _target_predictor;
+			std::mutex _control_lock;
+			ControlTarget _control_target;
+			double _control_output[3];                          // m/s , last output of the controller
+			VelocityCommander _velocity_commander;
+			std::mutex _watch_lock;
+			std::condition_variable _watch_changed;
+			Watch _watch;
 			bool    _takeoff();
 			bool    _scan();
 			bool    _land();
             bool    _fine_scan();
 			bool    _should_transit() const;
+			StepResult _watch_detections(const Event& event);   // the only state of the detection region
 
             //helpers
             bool _try_get_accurate_altitude(double & out);
+            bool _try_get_altitude(double & out);
+            bool _descend(double required_height, int frame_width, int frame_height,
+                          Video::Modifiers::Mask::TargetCenter& target_center_mask, Video::Modifiers::Mask::DirectionVector& direction_vector_mask);
+            void _control(double time);
+            bool _look(double& evidence);
 		};
 	}
 }
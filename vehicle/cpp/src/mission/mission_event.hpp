@@ -0,0 +1,38 @@
+#ifndef mission_event_hpp
+#define mission_event_hpp
+
+#include "../common/telemetry_store.hpp"
+#include "../algorithm/detection_service.hpp"
+
+/**
+ * what a state of a StateMachine reacts to
+ */
+namespace VehicleModule {
+    namespace Mission {
+        enum class EventType {
+            ENTER,              // the state was entered , the first event every state gets
+            FRAME_READY,        // the detection service processed a frame , found or not
+            TARGET_DETECTED,    // the detection service found the target in a frame (after FRAME_READY of the same frame)
+            TELEMETRY_UPDATE,   // a new snapshot of the vehicle
+            COMMAND_DONE,       // a command started with _run_command returned
+            TIMER,              // a timer started with _start_timer expired
+            SIGNAL,             // another region of the mission called _signal , the id says what happened
+            ABORT               // the mission must stop , comes before any other waiting event
+        };
+
+        struct Event {
+            EventType            type;
+            long long            timestamp;     // ms , when the event was posted , same clock as the telemetry
+            int                  id;            // of the timer , the command or the signal
+            bool                 succeeded;     // COMMAND_DONE , what the command returned
+            Algorithm::Detection detection;     // FRAME_READY and TARGET_DETECTED
+            Common::Telemetry    telemetry;     // TELEMETRY_UPDATE
+            long long            generation;    // set by the StateMachine , a timer , a command or an ENTER of a state that was left is dropped
+
+            Event(EventType type = EventType::ENTER, int id = 0)
+            : type(type), timestamp(Common::TelemetryStore::now_in_milliseconds()), id(id), succeeded(false), generation(0) {}
+        };
+    }
+}
+
+#endif /* mission_event_hpp */
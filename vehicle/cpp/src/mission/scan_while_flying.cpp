@@ -0,0 +1,147 @@
+#include "scan_while_flying.hpp"
+#include <cmath>
+#include <algorithm>
+#include <string>
+#include "../common/logger.hpp"
+#include "../video/video_provider.hpp"
+#include "../algorithm/ground_projection.hpp"
+
+using namespace VehicleModule::Mission;
+using namespace VehicleModule::Algorithm;
+using namespace VehicleModule::Video;
+using namespace VehicleModule::Common;
+
+ScanWhileFlying::ScanWhileFlying(DetectionService& detection_service, VelocityCommander& velocity_commander,
+                                 double required_confidence, double field_of_view, double speed)
+: _detection_service(detection_service), _velocity_commander(velocity_commander), _required_confidence(required_confidence),
+  _field_of_view(field_of_view), _speed(speed), _origin() {}
+
+bool ScanWhileFlying::is_available() {
+    Telemetry telemetry;
+    // no fix reads as 0 , 0
+    return TelemetryStore::get_instance().try_get_fresh(telemetry) && (telemetry.latitude != 0 || telemetry.longitude != 0);
+}
+
+bool ScanWhileFlying::run(const std::vector<cv::Point2d>& waypoints, Modifiers::Mask::TargetCenter& target_center_mask,
+                          const std::function<bool()>& should_stop) {
+    if (waypoints.empty() || !TelemetryStore::get_instance().try_get_fresh(_origin)) {
+        return false;
+    }
+
+    // the waypoints are relative to the heading of the start , the flight is on the ground
+    std::vector<cv::Point2d> ground;
+    for (const cv::Point2d& waypoint : waypoints) {
+        double north, east;
+        body_to_ground(waypoint.x, waypoint.y, 0, 0, 0, _origin.yaw, north, east);
+        ground.push_back(cv::Point2d(north, east));
+    }
+
+    DetectionAccumulator accumulator(_required_confidence, SCAN_GROUND_GATE);
+    long long last_sequence = 0;
+    size_t next = 0;
+    bool confirmed = false;
+    cv::Point2d target, leg_start(0, 0);
+    long long leg_started = TelemetryStore::now_in_milliseconds();
+    long long leg_timeout = _leg_timeout(cv::norm(ground[0]));
+    Logger::debug("Scanning " + std::to_string(ground.size()) + " waypoints at " + std::to_string(_speed) + " m/s", SCAN_WHILE_FLYING_TAG);
+
+    while (true) {
+        if (should_stop && should_stop()) {
+            _velocity_commander.hold();
+            return false;
+        }
+        Telemetry telemetry;
+        if (!TelemetryStore::get_instance().try_get_fresh(telemetry)) {
+            _velocity_commander.hold();
+            Logger::warn("Lost the telemetry while scanning", SCAN_WHILE_FLYING_TAG);
+            return false;
+        }
+        cv::Point2d position;
+        _local(telemetry, position.x, position.y);
+        long long now = TelemetryStore::now_in_milliseconds();
+
+        cv::Point2d goal = confirmed ? target : ground[next];
+        double distance = cv::norm(goal - position);
+        if (confirmed && distance < SCAN_ARRIVAL_RADIUS) {
+            _velocity_commander.hold();
+            Logger::debug("Over the target", SCAN_WHILE_FLYING_TAG);
+            return true;
+        }
+        if (!confirmed && (distance < SCAN_WAYPOINT_RADIUS || now - leg_started > leg_timeout)) {
+            if (distance >= SCAN_WAYPOINT_RADIUS) {
+                Logger::debug("Skipping waypoint " + std::to_string(next) + " , " + std::to_string(distance) + " meters away", SCAN_WHILE_FLYING_TAG);
+            }
+            leg_start = ground[next];
+            if (++next == ground.size()) {
+                _velocity_commander.hold();
+                Logger::debug("Did not find enough evidence of a target . found : " + std::to_string(accumulator.get_evidence()), SCAN_WHILE_FLYING_TAG);
+                return false;
+            }
+            leg_started = now;
+            leg_timeout = _leg_timeout(cv::norm(ground[next] - leg_start));
+            continue;
+        }
+        if (confirmed && now - leg_started > leg_timeout) {
+            _velocity_commander.hold();
+            Logger::warn("Could not reach the target , " + std::to_string(distance) + " meters away", SCAN_WHILE_FLYING_TAG);
+            return false;
+        }
+
+        // slow down on the last meter so the vehicle doesn't overshoot
+        double speed = std::min(_speed, distance);
+        double right, forward;
+        ground_to_body((goal.x - position.x) / distance * speed, (goal.y - position.y) / distance * speed, telemetry.yaw, right, forward);
+        if (!_velocity_commander.send(forward, right, 0)) {
+            std::string error;
+            _velocity_commander.take_failures(error);
+            Logger::warn("Could not send the velocity : " + error, SCAN_WHILE_FLYING_TAG);
+            return false;
+        }
+
+        Detection detection;
+        if (!_detection_service.wait_for_next(last_sequence, detection, SCAN_UPDATE_PERIOD)) {
+            continue;
+        }
+        last_sequence = detection.sequence;
+        cv::Point2d hit;
+        double radius;
+        if (detection.result.found && _locate(detection, hit, radius)) {
+            accumulator.add(hit, radius, detection.result.confidence);
+            target_center_mask.set_target_center(detection.result.center);
+            Logger::debug("Found target at north:" + std::to_string(hit.x) + " east:" + std::to_string(hit.y), SCAN_WHILE_FLYING_TAG);
+        } else {
+            accumulator.add(cv::Point2d(), 0, 0);
+        }
+
+        // the hits that keep coming on the way refine the target
+        if (accumulator.is_confirmed() && accumulator.get_center(target) && !confirmed) {
+            confirmed = true;
+            leg_started = now;
+            leg_timeout = _leg_timeout(cv::norm(target - position));
+            Logger::debug("Target confirmed , diverting to north:" + std::to_string(target.x) + " east:" + std::to_string(target.y), SCAN_WHILE_FLYING_TAG);
+        }
+    }
+}
+
+void ScanWhileFlying::_local(const Telemetry& telemetry, double& north, double& east) const {
+    geodetic_to_local(telemetry.latitude, telemetry.longitude, _origin.latitude, _origin.longitude, north, east);
+}
+
+bool ScanWhileFlying::_locate(const Detection& detection, cv::Point2d& position, double& radius) const {
+    double height = detection.telemetry.get_height();
+    if (!detection.has_telemetry || height <= 0) {
+        return false;
+    }
+    VideoProvider& video_provider = VideoProvider::get_instance();
+    double right, forward, north, east;
+    frame_to_body(detection.result.center, video_provider.get_width(), video_provider.get_height(), height, _field_of_view, right, forward);
+    body_to_ground(right, forward, height, detection.telemetry.roll, detection.telemetry.pitch, detection.telemetry.yaw, north, east);
+    _local(detection.telemetry, position.x, position.y);
+    position += cv::Point2d(north, east);
+    radius = detection.result.radius * meters_per_pixel(video_provider.get_width(), height, _field_of_view);
+    return true;
+}
+
+long long ScanWhileFlying::_leg_timeout(double length) const {
+    return std::max((long long) SCAN_MIN_LEG_TIMEOUT, (long long) (SCAN_LEG_TIMEOUT_FACTOR * 1000 * length / _speed));
+}
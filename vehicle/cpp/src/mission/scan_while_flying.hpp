@@ -0,0 +1,71 @@
+#ifndef scan_while_flying_hpp
+#define scan_while_flying_hpp
+
+#include <functional>
+#include <vector>
+#include <opencv2/core/types.hpp>
+#include "../common/telemetry_store.hpp"
+#include "../algorithm/detection_service.hpp"
+#include "../algorithm/detection_accumulator.hpp"
+#include "../video/modifiers/mask/target_center.hpp"
+#include "velocity_commander.hpp"
+
+#define SCAN_SPEED 1.0                  // meters per second , along the waypoints
+#define SCAN_WAYPOINT_RADIUS 0.3        // meters , a waypoint closer than this is reached
+#define SCAN_ARRIVAL_RADIUS 0.2         // meters , the vehicle is over the target
+#define SCAN_GROUND_GATE 0.5            // meters , hits closer than this on the ground are the same target
+#define SCAN_UPDATE_PERIOD 200          // ms , the velocity is sent at least this often even without frames
+#define SCAN_LEG_TIMEOUT_FACTOR 3       // a leg may take this many times its length at SCAN_SPEED before it is skipped
+#define SCAN_MIN_LEG_TIMEOUT 5000       // ms
+#define SCAN_WHILE_FLYING_TAG "ScanWhileFlying"
+
+/**
+ * looks for the target while the vehicle flies through the waypoints without stopping
+ * every frame is processed , a hit is put on the ground with the position and attitude of its capture time (see
+ * ground_projection) and the hits are accumulated on the ground , so frames of a moving camera add up as if they
+ * were taken from the same place . once the evidence is enough the vehicle turns to the target right away
+ * needs telemetry with a position , see is_available , the caller falls back to stop and stare without it
+ */
+namespace VehicleModule {
+    namespace Mission {
+        class ScanWhileFlying {
+        public:
+            /**
+             * @param detection_service   started by the caller
+             * @param velocity_commander  connected by the caller
+             * @param required_confidence evidence needed to declare a target (see DetectionAccumulator)
+             * @param field_of_view       horizontal field of view of the camera in radians
+             * @param speed               meters per second
+             */
+            ScanWhileFlying(Algorithm::DetectionService& detection_service, VelocityCommander& velocity_commander,
+                            double required_confidence, double field_of_view, double speed = SCAN_SPEED);
+            /**
+             * @return true if there is fresh telemetry with a position
+             */
+            static bool is_available();
+            /**
+             * fly through the waypoints and stop over the target
+             * @param  waypoints          x meters right and y meters forward of the start , at the heading of the start
+             * @param  target_center_mask shows the hits
+             * @param  should_stop        polled every frame , true to stop right away (abort)
+             * @return true if a target was confirmed and the vehicle holds over it , false if the waypoints ended , the
+             *         telemetry was lost or it was stopped (the vehicle holds where it is)
+             */
+            bool run(const std::vector<cv::Point2d>& waypoints, Video::Modifiers::Mask::TargetCenter& target_center_mask,
+                     const std::function<bool()>& should_stop = std::function<bool()>());
+        private:
+            Algorithm::DetectionService& _detection_service;
+            VelocityCommander&           _velocity_commander;
+            double                       _required_confidence;
+            double                       _field_of_view;
+            double                       _speed;
+            Common::Telemetry            _origin;
+
+            void      _local(const Common::Telemetry& telemetry, double& north, double& east) const;
+            bool      _locate(const Algorithm::Detection& detection, cv::Point2d& position, double& radius) const;
+            long long _leg_timeout(double length) const;
+        };
+    }
+}
+
+#endif /* scan_while_flying_hpp */
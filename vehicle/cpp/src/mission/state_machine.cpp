@@ -1,26 +1,40 @@
 #include "state_machine.hpp"
+#include <boost/python/errors.hpp>
 
 #define DUMMY_LAST_STATE_ID -1
 
 using namespace VehicleModule::Mission;
 using namespace std;
 
-StateMachine::StateMachine() : _current_state(0) {
-    State dummyLastState(DUMMY_LAST_STATE_ID, "Dummy last state", NULL);
-    _states[DUMMY_LAST_STATE_ID] = dummyLastState;
+thread_local StateMachine::Region* StateMachine::_running_region = nullptr;
+
+StateMachine::StateMachine()
+: _abort_requested(false), _ended(false) {
+    _regions.push_back(std::unique_ptr<Region>(new Region(this, TAG)));
+}
+
+StateMachine::~StateMachine() {
+    for (const std::shared_ptr<Mailbox>& mailbox : _mailboxes()) {
+        std::lock_guard<std::mutex> guard(mailbox->lock);
+        mailbox->closed = true;
+    }
+    _remove_listeners();
 }
 
 void StateMachine::start() {
     ::Common::GilLock lk;
     lk.unlock();
-    if (_states.find(STARTING_STATE_ID) == _states.end()) {
-        throw StateMachineException("No starting state");
+    for (const std::unique_ptr<Region>& region : _regions) {
+        if (!_has_state(*region, STARTING_STATE_ID)) {
+            throw StateMachineException("No starting state in " + region->name);
+        }
     }
     std::cout<< "mark3";
     int last_id = DUMMY_LAST_STATE_ID;
     bool machine_may_stop = false;
-    for (unordered_map<int, State>::const_iterator itr = _states.cbegin(); itr != _states.cend(); ++itr) {
-        if (any_of(itr->second.transitions.cbegin(), itr->second.transitions.cend(), [&last_id](const Transition& transition) { return transition.dest == last_id; })) {
+    const vector<State>& states = _regions[MAIN_REGION]->states;
+    for (vector<State>::const_iterator itr = states.cbegin(); itr != states.cend(); ++itr) {
+        if (any_of(itr->transitions.cbegin(), itr->transitions.cend(), [&last_id](const Transition& transition) { return transition.dest == last_id; })) {
             machine_may_stop = true;
         }
     }
@@ -30,62 +44,393 @@ void StateMachine::start() {
     }
 
     Common::Logger::info("Starting mission", TAG);
-    while (_current_state != DUMMY_LAST_STATE_ID) {
-        loop();
+    // the other regions enter first , so what the main region does on ENTER can already signal them
+    for (size_t i = _regions.size(); i-- > 0;) {
+        Region& region = *_regions[i];
+        std::shared_ptr<Mailbox> mailbox = region.mailbox;
+        bool aborted;
+        int first_id;
+        {
+            // under the lock of the mailbox , so an ABORT either was requested already or finds the first state
+            std::unique_lock<std::mutex> guard(mailbox->lock);
+            // an event that came before the start found no state , let it be dropped first
+            mailbox->changed.wait(guard, [&mailbox]() { return !mailbox->dispatching; });
+            // abort may come before start (mission_executer arms the vehicle in between) , go to the abort state right away
+            aborted = _abort_requested;
+            first_id = aborted ? region.abort_state : STARTING_STATE_ID;
+            region.aborted = aborted;
+            region.current_state = first_id;
+            region.generation++;
+            if (first_id == DUMMY_LAST_STATE_ID) {
+                mailbox->closed = true;
+                mailbox->events.clear();
+            } else {
+                Event event(EventType::ENTER);
+                event.generation = region.generation;
+                mailbox->events.push_front(event);
+                mailbox->dispatching = true;
+            }
+        }
+        if (aborted) {
+            Common::Logger::warn("Mission was aborted before it started", region.name);
+        }
+        if (first_id == DUMMY_LAST_STATE_ID) {
+            continue;
+        }
+        const State& first = region.states[first_id];
+        if (i == MAIN_REGION) {
+            Common::Logger::state(first.id, first.description, TAG);
+        } else {
+            Common::Logger::info("Current state is '" + first.description + "'", region.name);
+        }
+        Common::Executor::get_instance().post([mailbox]() { _dispatch(mailbox); });
+    }
+
+    string error;
+    std::shared_ptr<Mailbox> main = _regions[MAIN_REGION]->mailbox;
+    {
+        std::unique_lock<std::mutex> guard(main->lock);
+        main->changed.wait(guard, [&main]() { return main->closed && !main->dispatching; });
+        error = main->error;
     }
+    // the mission may be destroyed once start returns , no state of any region may still run
+    _ended = true;
+    for (size_t i = MAIN_REGION + 1; i < _regions.size(); i++) {
+        std::shared_ptr<Mailbox> mailbox = _regions[i]->mailbox;
+        std::unique_lock<std::mutex> guard(mailbox->lock);
+        mailbox->closed = true;
+        mailbox->events.clear();
+        mailbox->changed.wait(guard, [&mailbox]() { return !mailbox->dispatching; });
+    }
+    _remove_listeners();
 
+    if (!error.empty()) {
+        lk.lock();
+        throw StateMachineException(error);
+    }
     Common::Logger::info("Mission completed", TAG);
     lk.lock();
 }
 
-void StateMachine::_add_state(const State& state) {
-    if (_states.find(state.id) != _states.end()) {
+void StateMachine::post_event(const Event& event) {
+    for (const std::shared_ptr<Mailbox>& mailbox : _mailboxes()) {
+        _post(mailbox, event);
+    }
+}
+
+void StateMachine::abort() {
+    _abort_requested = true;
+    post_event(Event(EventType::ABORT));
+}
+
+int StateMachine::_add_region(const string& name) {
+    _regions.push_back(std::unique_ptr<Region>(new Region(this, name)));
+    return (int) _regions.size() - 1;
+}
+
+void StateMachine::_add_state(const State& state, int region) {
+    Region& target = _region(region);
+    if (state.id < 0) {
+        throw StateMachineException("State id must not be negative");
+    }
+    if (_has_state(target, state.id)) {
         throw StateMachineException("State" + to_string(state.id) + " already exists");
     }
 
-    _states[state.id] = state;
+    if (state.id >= (int) target.states.size()) {
+        target.states.resize(state.id + 1);
+    }
+    target.states[state.id] = state;
 }
 
-void StateMachine::_add_transition(const Transition& transition) {
-    if (_states.find(transition.origin) == _states.end()
-        || _states.find(transition.dest) == _states.end()) {
+void StateMachine::_add_transition(const Transition& transition, int region) {
+    Region& target = _region(region);
+    if (!_has_state(target, transition.origin)
+        || (!_has_state(target, transition.dest) && transition.dest != DUMMY_LAST_STATE_ID)) {
         throw StateMachineException("State doesn't exist");
     }
-    _states[transition.origin].transitions.push_back(transition);
+    target.states[transition.origin].transitions.push_back(transition);
 }
 
-int StateMachine::loop() {
-    const State& curr = _get_current_state();
-    Common::Logger::state(curr.id, curr.description, TAG);
+void StateMachine::_set_abort_state(int id, int region) {
+    Region& target = _region(region);
+    if (!_has_state(target, id)) {
+        throw StateMachineException("State doesn't exist");
+    }
+    target.abort_state = id;
+}
+
+void StateMachine::_start_timer(int id, int delay_ms) {
+    Region& region = _current_region();
+    std::shared_ptr<Mailbox> mailbox = region.mailbox;
+    long long generation = region.generation;
+    Common::Executor::get_instance().post_after(delay_ms, [mailbox, id, generation]() {
+        Event event(EventType::TIMER, id);
+        event.generation = generation;
+        _post(mailbox, event);
+    });
+}
+
+void StateMachine::_run_command(int id, const std::function<bool()>& command) {
+    Region& region = _current_region();
+    std::shared_ptr<Mailbox> mailbox = region.mailbox;
+    long long generation = region.generation;
+    Common::Executor::get_instance().post([mailbox, id, command, generation]() {
+        Event event(EventType::COMMAND_DONE, id);
+        event.generation = generation;
+        try {
+            event.succeeded = command();
+        } catch (boost::python::error_already_set&) {
+            BEGIN_PYTHON_EXECUTION
+            PyErr_Print();
+            END_PYTHON_EXECUTION
+        } catch (std::exception& ex) {
+            Common::Logger::critical("Command " + to_string(id) + " failed : " + ex.what(), TAG);
+        }
+        _post(mailbox, event);
+    });
+}
+
+void StateMachine::_signal(int id) {
+    const Region& from = _current_region();
+    for (const std::unique_ptr<Region>& region : _regions) {
+        if (region.get() != &from) {
+            _post(region->mailbox, Event(EventType::SIGNAL, id));
+        }
+    }
+}
+
+void StateMachine::_listen_to(Algorithm::DetectionService& detection_service) {
+    std::shared_ptr<Mailbox> mailbox = _current_region().mailbox;
+    int id = detection_service.add_listener([mailbox](const Algorithm::Detection& detection) {
+        Event event(EventType::FRAME_READY);
+        event.detection = detection;
+        _post(mailbox, event);
+        if (detection.result.found) {
+            event.type = EventType::TARGET_DETECTED;
+            _post(mailbox, event);
+        }
+    });
+    std::lock_guard<std::mutex> guard(_listening_lock);
+    _stop_listening.push_back([&detection_service, id]() { detection_service.remove_listener(id); });
+}
+
+void StateMachine::_listen_to_telemetry() {
+    std::shared_ptr<Mailbox> mailbox = _current_region().mailbox;
+    int id = Common::TelemetryStore::get_instance().add_listener([mailbox](const Common::Telemetry& telemetry) {
+        Event event(EventType::TELEMETRY_UPDATE);
+        event.telemetry = telemetry;
+        _post(mailbox, event);
+    });
+    std::lock_guard<std::mutex> guard(_listening_lock);
+    _stop_listening.push_back([id]() { Common::TelemetryStore::get_instance().remove_listener(id); });
+}
+
+void StateMachine::_remove_listeners() {
+    vector<std::function<void()> > stop_listening;
+    {
+        std::lock_guard<std::mutex> guard(_listening_lock);
+        stop_listening.swap(_stop_listening);
+    }
+    for (const std::function<void()>& stop : stop_listening) {
+        stop();
+    }
+}
+
+void StateMachine::_post(const std::shared_ptr<Mailbox>& mailbox, const Event& event) {
+    {
+        std::lock_guard<std::mutex> guard(mailbox->lock);
+        if (mailbox->closed) {
+            return;
+        }
+        if (event.type == EventType::ABORT) {
+            mailbox->events.push_front(event);
+        } else if (event.type == EventType::ENTER) {
+            // the new state starts before the events that were queued for the old one , but not before an abort
+            bool after_abort = !mailbox->events.empty() && mailbox->events.front().type == EventType::ABORT;
+            mailbox->events.insert(mailbox->events.begin() + (after_abort ? 1 : 0), event);
+        } else {
+            mailbox->events.push_back(event);
+        }
+        if (mailbox->dispatching) {
+            return;
+        }
+        mailbox->dispatching = true;
+    }
+    std::shared_ptr<Mailbox> target = mailbox;
+    Common::Executor::get_instance().post([target]() { _dispatch(target); });
+}
+
+void StateMachine::_dispatch(const std::shared_ptr<Mailbox>& mailbox) {
+    std::unique_lock<std::mutex> guard(mailbox->lock);
+    while (!mailbox->events.empty() && !mailbox->closed) {
+        Event event = mailbox->events.front();
+        mailbox->events.pop_front();
+        guard.unlock();
+        StateMachine* owner = mailbox->owner;
+        Region& region = *mailbox->region;
+        string error;
+        _running_region = &region;
+        try {
+            owner->_handle(region, event);
+        } catch (boost::python::error_already_set&) {
+            BEGIN_PYTHON_EXECUTION
+            PyErr_Print();
+            END_PYTHON_EXECUTION
+            error = "Python error in state " + to_string(region.current_state);
+        } catch (std::exception& ex) {
+            error = ex.what();
+            if (error.empty()) {
+                // an empty error would end the region as if it succeeded
+                error = "Error in state " + to_string(region.current_state);
+            }
+        }
+        _running_region = nullptr;
+        if (!error.empty()) {
+            owner->_close(region, error);
+            if (&region != owner->_regions[MAIN_REGION].get()) {
+                // a region that failed fails the mission
+                owner->_close(*owner->_regions[MAIN_REGION], region.name + " : " + error);
+            }
+        }
+        guard.lock();
+    }
+    mailbox->dispatching = false;
+    mailbox->changed.notify_all();
+}
+
+void StateMachine::_handle(Region& region, const Event& event) {
+    if (region.current_state == DUMMY_LAST_STATE_ID) {
+        return;
+    }
+    const State& curr = region.states[region.current_state];
+
+    if (event.type == EventType::ABORT) {
+        if (region.aborted) {
+            return;
+        }
+        region.aborted = true;
+        Common::Logger::warn("Aborting mission in state " + to_string(curr.id), region.name);
+        if (curr.handler) {
+            // to clean up , the result doesn't matter
+            (this->*curr.handler)(event);
+        }
+        _enter(region, region.current_state != region.abort_state ? region.abort_state : DUMMY_LAST_STATE_ID);
+        return;
+    }
+    if ((event.type == EventType::TIMER || event.type == EventType::ENTER || event.type == EventType::COMMAND_DONE)
+        && event.generation != region.generation) {
+        // of a state that was left already
+        return;
+    }
 
     bool state_result = true;
-    if (curr.function) {
+    if (curr.handler) {
+        StepResult result = (this->*curr.handler)(event);
+        if (result == StepResult::STAY) {
+            return;
+        }
+        state_result = result == StepResult::SUCCEEDED;
+    } else if (event.type != EventType::ENTER) {
+        return;
+    } else if (curr.function) {
         state_result = (this->*curr.function)();
+    } else {
+        Common::Logger::warn("No function for state " + to_string(curr.id), region.name);
     }
-    else {
-        Common::Logger::warn("No function for state " + to_string(curr.id), TAG);
+    region.last_state_succeed = state_result;
+    if (&region == _regions[MAIN_REGION].get()) {
+        _last_state_succeed = state_result;
     }
-    _last_state_succeed = state_result;
 
+    int next = curr.id;
     for (vector<Transition>::const_iterator itr = curr.transitions.cbegin(); itr != curr.transitions.cend(); ++itr) {
         if ((this->*itr->function)()) {
-            _current_state = itr->dest;
+            next = itr->dest;
         }
     }
+    _enter(region, next);
+}
+
+void StateMachine::_enter(Region& region, int id) {
+    region.current_state = id;
+    region.generation++;
+    if (id == DUMMY_LAST_STATE_ID) {
+        _close(region, "");
+        return;
+    }
+    const State& curr = region.states[id];
+    if (&region == _regions[MAIN_REGION].get()) {
+        Common::Logger::state(curr.id, curr.description, TAG);
+    } else {
+        // the state of the mission that is reported is the one of the main region
+        Common::Logger::info("Current state is '" + curr.description + "'", region.name);
+    }
+    Event event(EventType::ENTER);
+    event.generation = region.generation;
+    _post(region.mailbox, event);
+}
 
-    return state_result;
+void StateMachine::_close(Region& region, const string& error) {
+    std::lock_guard<std::mutex> guard(region.mailbox->lock);
+    if (region.mailbox->closed) {
+        return;
+    }
+    region.mailbox->closed = true;
+    region.mailbox->error = error;
+    region.mailbox->events.clear();
+    region.mailbox->changed.notify_all();
 }
 
-const StateMachine::State& StateMachine::_get_current_state() {
-    return _states[_current_state];
+StateMachine::Region& StateMachine::_region(int id) {
+    if (id < 0 || id >= (int) _regions.size()) {
+        throw StateMachineException("Region doesn't exist");
+    }
+    return *_regions[id];
+}
+
+StateMachine::Region& StateMachine::_current_region() const {
+    // a state runs on the dispatch task of its region , anything else acts for the main region
+    if (_running_region != nullptr && _running_region->mailbox->owner == this) {
+        return *_running_region;
+    }
+    return *_regions[MAIN_REGION];
+}
+
+vector<std::shared_ptr<StateMachine::Mailbox> > StateMachine::_mailboxes() const {
+    vector<std::shared_ptr<Mailbox> > mailboxes;
+    for (const std::unique_ptr<Region>& region : _regions) {
+        mailboxes.push_back(region->mailbox);
+    }
+    return mailboxes;
+}
+
+bool StateMachine::_has_state(const Region& region, int id) const {
+    // an id that was skipped holds an empty State
+    return id >= 0 && id < (int) region.states.size() && region.states[id].id == id;
+}
+
+bool StateMachine::_last_result() const {
+    return _current_region().last_state_succeed;
 }
 
 bool StateMachine::_transit_to_last() const {
-    return _last_state_succeed;
+    return _last_result();
 }
 
+StateMachine::Region::Region(StateMachine* owner, const string& name)
+: name(name), current_state(DUMMY_LAST_STATE_ID), abort_state(DUMMY_LAST_STATE_ID), generation(0), aborted(false),
+  last_state_succeed(false), mailbox(new Mailbox(owner, this)) {}
+
 StateMachine::State::State(int id, const string& description, st_func function, bool last)
-: id(id), description(description), function(function), last(last) {
+: id(id), description(description), last(last), function(function), handler(nullptr) {
+    if (last) {
+        transitions.push_back(Transition(id, DUMMY_LAST_STATE_ID, &StateMachine:: _transit_to_last));
+    }
+}
+
+StateMachine::State::State(int id, const string& description, ev_func handler, bool last)
+: id(id), description(description), last(last), function(nullptr), handler(handler) {
     if (last) {
         transitions.push_back(Transition(id, DUMMY_LAST_STATE_ID, &StateMachine:: _transit_to_last));
     }
@@ -11,43 +11,89 @@
 
 #include <string>
 #include <vector>
-#include <unordered_map>
 #include <exception>
 #include "../common/vehicle_module_exception.hpp"
 #include "../common/logger.hpp"
 #include <string>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
 #include "gil_lock.hpp"
+#include "mission_event.hpp"
+#include "../common/executor.hpp"
 
 #define STARTING_STATE_ID 0
+#define MAIN_REGION 0
 #define TAG "StateMachine"
 
 using namespace std;
 
+/**
+ * a mission as states and the transitions between them
+ * the machine is event driven : the events of a mission (see EventType) are queued and handed one at a time to the
+ * current state on the shared Executor , so a mission doesn't hold a thread while it waits and an abort or a timer is
+ * handled within one event . a state either
+ *   - reacts to events ('ev_func') : every call is a short step that returns STAY to keep waiting or the result of
+ *     the state . slow work goes to _run_command and comes back as COMMAND_DONE
+ *   - or is a blocking function ('st_func') , run once on ENTER like before . it holds a worker till it returns and
+ *     sees an abort only through _is_aborted
+ * once a state has a result the transitions of the state are evaluated , the last one that fires wins and if none
+ * fires the state is entered again
+ * a mission may have more regions (see _add_region) next to the main one , each with its own states and its own
+ * current state . the regions run in parallel on different workers , a region gets what its states listen to (and
+ * post_event and ABORT) and they talk with _signal , e.g. a detection region that keeps looking while the main region moves the vehicle from state to
+ * state . the mission ends when the main region ends
+ */
 namespace VehicleModule {
     namespace Mission {
         class StateMachine {
         public:
+            /**
+             * run the mission , blocks till it ends
+             * throws the error of a state as a StateMachineException
+             */
             virtual void start();
-            
+            /**
+             * queue an event for the current state of every region , may be called from any thread
+             */
+            void post_event(const Event& event);
+            /**
+             * stop the mission : the current state of every region gets ABORT and the region goes to its abort state (see
+             * _set_abort_state) or ends . if it comes before start the mission starts in the abort state
+             */
+            void abort();
+            virtual ~StateMachine();
+
             struct StateMachineException : public Common::VehicleModuleException {
                 StateMachineException(const string& message) : Common::VehicleModuleException(message) {}
             };
-            
-        protected:
-            bool                        _last_state_succeed;
-            
+
+            enum class StepResult {
+                STAY,       // wait for the next event
+                SUCCEEDED,
+                FAILED
+            };
+
             typedef bool (StateMachine::*st_func)();
             typedef bool (StateMachine::*tr_func)() const;
+            typedef StepResult (StateMachine::*ev_func)(const Event& event);
+
+        protected:
+            bool                        _last_state_succeed;
+
             StateMachine();
-            
+
             class Transition {
             public:
                 int     origin, dest;
                 tr_func function;
-                
+
                 Transition(int origin, int dest, tr_func function);
             };
-            
+
             class State{
             public:
                 int                 id;
@@ -55,23 +101,146 @@ namespace VehicleModule {
                 bool                last;
                 vector<Transition>  transitions;
                 st_func             function;
-                
+                ev_func             handler;
+
                 State(int id, const string& description, st_func function, bool last=false);
-                State() {}
+                State(int id, const string& description, ev_func handler, bool last=false);
+                State() : id(-1), last(false), function(nullptr), handler(nullptr) {}
             };
-            
-            void _add_state(const State& state);
-            void _add_transition(const Transition& transition);
-            
+
+            /**
+             * a region that runs in parallel to the main one , only in the constructor of the mission
+             * the states of the region are members of the mission too , they run on another worker at the same time
+             * as the states of the main region so what they share must be locked . the region starts and gets ABORT
+             * with the main region , and is stopped once the main region ended (a blocking state should poll
+             * _is_aborted) . a region that should run for the whole mission may have a last state that keeps
+             * returning STAY
+             * @param  name logged with the states of the region
+             * @return the id of the region
+             */
+            int _add_region(const string& name);
+            /**
+             * the states and the transitions of a StateTable , checked when the mission is compiled
+             * @param descriptions of the states by id
+             * @param region       see _add_region
+             */
+            template <typename Definition, size_t N>
+            void _load(const char* const (&descriptions)[N], int region = MAIN_REGION);
+            /**
+             * the same one by one , checked when the mission starts
+             */
+            void _add_state(const State& state, int region = MAIN_REGION);
+            void _add_transition(const Transition& transition, int region = MAIN_REGION);
+            /**
+             * the state to go to on abort (landing etc.) , by default the region just ends
+             */
+            void _set_abort_state(int id, int region = MAIN_REGION);
+            /**
+             * @param id       comes back in the TIMER event
+             * @param delay_ms
+             * the timer is dropped if the state is left before it expires , it comes back to the region that started it
+             */
+            void _start_timer(int id, int delay_ms);
+            /**
+             * run a slow call (python commands etc.) on the executor , COMMAND_DONE comes back with what it returned
+             * the command may still run after the mission ended , it must not use the mission (capture by value)
+             * @param id comes back in the COMMAND_DONE event , to the region that ran it . it is dropped if the state
+             *           was left before the command returned
+             */
+            void _run_command(int id, const std::function<bool()>& command);
+            /**
+             * post SIGNAL with the id to every other region of the mission
+             */
+            void _signal(int id);
+            /**
+             * get FRAME_READY and TARGET_DETECTED for every result of the service , till the mission ends
+             * they go to the region of the state that called it , a region that blocks doesn't pile them up
+             */
+            void _listen_to(Algorithm::DetectionService& detection_service);
+            /**
+             * get TELEMETRY_UPDATE for every snapshot of the TelemetryStore , till the mission ends , in the region of the
+             * state that called it
+             */
+            void _listen_to_telemetry();
+            /**
+             * for blocking states , true as soon as abort was called , or once the main region ended
+             */
+            bool _is_aborted() const { return _abort_requested || _ended; }
+            /**
+             * for transitions , what the state that was just left returned in the region that evaluates the
+             * transition (_last_state_succeed is of the main region)
+             */
+            bool _last_result() const;
+
         private:
-            unordered_map<int, State>   _states;
-            int                         _current_state;
-            bool                        _transit_to_last() const;
-            
-            const State& _get_current_state();
-            int loop();
+            struct Region;
+
+            // what the executor tasks , the timers and the listeners hold , it outlives the machine if it must
+            struct Mailbox {
+                std::mutex              lock;
+                std::condition_variable changed;
+                std::deque<Event>       events;
+                bool                    dispatching;    // a dispatch task is posted or running
+                bool                    closed;         // the region ended , events are dropped
+                string                  error;          // what a state threw
+                StateMachine*           owner;
+                Region*                 region;
+
+                Mailbox(StateMachine* owner, Region* region) : dispatching(false), closed(false), owner(owner), region(region) {}
+            };
+
+            // a current state and its events , only the dispatch task of the region touches it once the mission started
+            struct Region {
+                string                      name;
+                vector<State>               states;             // by id , a flat array so a step is one index away
+                int                         current_state;
+                int                         abort_state;
+                long long                   generation;         // bumped on every state change
+                bool                        aborted;
+                bool                        last_state_succeed;
+                std::shared_ptr<Mailbox>    mailbox;
+
+                Region(StateMachine* owner, const string& name);
+            };
+
+            vector<std::unique_ptr<Region> >    _regions;           // by id , MAIN_REGION first
+            std::atomic_bool                    _abort_requested;
+            std::atomic_bool                    _ended;             // the main region ended , the others are stopped
+            std::mutex                          _listening_lock;    // states of different regions may start listening together
+            vector<std::function<void()> >      _stop_listening;
+            bool                                _transit_to_last() const;
+
+            static thread_local Region*         _running_region;    // of the dispatch task on this worker
+
+            Region& _region(int id);
+            Region& _current_region() const;
+            vector<std::shared_ptr<Mailbox> > _mailboxes() const;
+            bool _has_state(const Region& region, int id) const;
+            void _handle(Region& region, const Event& event);
+            void _enter(Region& region, int id);
+            void _close(Region& region, const string& error);
+            void _remove_listeners();
+
+            static void _post(const std::shared_ptr<Mailbox>& mailbox, const Event& event);
+            static void _dispatch(const std::shared_ptr<Mailbox>& mailbox);
         };
     }
 }
 
+template <typename Definition, size_t N>
+void VehicleModule::Mission::StateMachine::_load(const char* const (&descriptions)[N], int region) {
+    static_assert(N == Definition::size, "one description per state");
+    vector<State>& states = _region(region).states;
+    states.assign(N, State());
+    Definition::each_state([&states, &descriptions](int id, bool last, st_func function, ev_func handler) {
+        states[id] = function ? State(id, descriptions[id], function, last) : State(id, descriptions[id], handler, last);
+    });
+    Definition::each_transition([&states](int origin, int dest, tr_func guard) {
+        states[origin].transitions.push_back(Transition(origin, dest, guard));
+    });
+    if (Definition::abort_state >= 0) {
+        _region(region).abort_state = Definition::abort_state;
+    }
+}
+
 #endif /* state_machine_hpp */
@@ -0,0 +1,157 @@
+#ifndef transition_table_hpp
+#define transition_table_hpp
+
+#include <functional>
+#include <type_traits>
+#include "state_machine.hpp"
+
+#define TRANSITION_TABLE_MAX_STATES 64     // the checks keep a set of states in one 64 bit mask
+
+/**
+ * the states and the transitions of a mission as types , so a broken mission doesn't compile
+ *     typedef StateTable<MyMission> Table;
+ *     typedef Table::Definition<
+ *         Table::States<
+ *             Table::Blocking<0, &MyMission::_takeoff>,
+ *             Table::Reacting<1, &MyMission::_land, true>>,
+ *         Table::Transitions<
+ *             Table::Transit<0, 1, &MyMission::_should_transit>>,
+ *         1> Definition;                                       // the abort state , optional
+ *     _load<Definition>(descriptions);
+ * checked when the mission is compiled (instead of the StateMachineExceptions of _add_state and start) :
+ *   - the ids are 0 .. number of states - 1 , each once
+ *   - every transition goes between states of the table
+ *   - every state that is not last has a way out
+ *   - a last state can be reached from the starting state , and from every state the machine can get to
+ *   - the abort state is a state of the table
+ * the functions are members of the mission itself , the cast to the StateMachine types is done here once
+ */
+namespace VehicleModule {
+    namespace Mission {
+        namespace TransitionTableCheck {
+            typedef unsigned long long Mask;
+
+            constexpr Mask bit(int id) {
+                return id >= 0 && id < TRANSITION_TABLE_MAX_STATES ? Mask(1) << id : 0;
+            }
+            constexpr Mask first(int n) {
+                return n >= TRANSITION_TABLE_MAX_STATES ? ~Mask(0) : (Mask(1) << n) - 1;
+            }
+
+            // the set of the ids , out of range ids are left out
+            constexpr Mask mask() { return 0; }
+            template <typename... Ids>
+            constexpr Mask mask(int id, Ids... rest) { return bit(id) | mask(rest...); }
+
+            constexpr bool all_in(Mask) { return true; }
+            template <typename... Ids>
+            constexpr bool all_in(Mask ids, int id, Ids... rest) {
+                return (ids & bit(id)) != 0 && all_in(ids, rest...);
+            }
+
+            // a transition as one int , so the origins and the destinations stay in one pack
+            constexpr int edge(int origin, int dest) { return origin * TRANSITION_TABLE_MAX_STATES + dest; }
+            constexpr int origin(int edge) { return edge / TRANSITION_TABLE_MAX_STATES; }
+            constexpr int dest(int edge) { return edge % TRANSITION_TABLE_MAX_STATES; }
+
+            constexpr Mask successors(Mask) { return 0; }
+            template <typename... Edges>
+            constexpr Mask successors(Mask from, int edge, Edges... rest) {
+                return ((from & bit(origin(edge))) != 0 ? bit(dest(edge)) : 0) | successors(from, rest...);
+            }
+
+            constexpr Mask predecessors(Mask to) { return 0; }
+            template <typename... Edges>
+            constexpr Mask predecessors(Mask to, int edge, Edges... rest) {
+                return ((to & bit(dest(edge))) != 0 ? bit(origin(edge)) : 0) | predecessors(to, rest...);
+            }
+
+            // every state that can be reached from the set , the set included
+            template <typename... Edges>
+            constexpr Mask reach(Mask from, Edges... edges) {
+                return (from | successors(from, edges...)) == from ? from : reach(from | successors(from, edges...), edges...);
+            }
+
+            // every state the set can be reached from , the set included
+            template <typename... Edges>
+            constexpr Mask reached_by(Mask to, Edges... edges) {
+                return (to | predecessors(to, edges...)) == to ? to : reached_by(to | predecessors(to, edges...), edges...);
+            }
+        }
+
+        template <typename M>
+        struct StateTable {
+            static_assert(std::is_base_of<StateMachine, M>::value, "a table is of a mission");
+
+            typedef bool (M::*Function)();
+            typedef StateMachine::StepResult (M::*Handler)(const Event& event);
+            typedef bool (M::*Guard)() const;
+
+            /**
+             * a state that runs once on ENTER (see StateMachine::st_func)
+             */
+            template <int Id, Function F, bool Last = false>
+            struct Blocking {
+                enum { id = Id, last = Last };
+                static StateMachine::st_func function() { return static_cast<StateMachine::st_func>(F); }
+                static StateMachine::ev_func handler() { return nullptr; }
+            };
+
+            /**
+             * a state that reacts to events (see StateMachine::ev_func)
+             */
+            template <int Id, Handler H, bool Last = false>
+            struct Reacting {
+                enum { id = Id, last = Last };
+                static StateMachine::st_func function() { return nullptr; }
+                static StateMachine::ev_func handler() { return static_cast<StateMachine::ev_func>(H); }
+            };
+
+            template <int Origin, int Dest, Guard G>
+            struct Transit {
+                enum { origin = Origin, dest = Dest };
+                static StateMachine::tr_func guard() { return static_cast<StateMachine::tr_func>(G); }
+            };
+
+            template <typename... S> struct States {};
+            template <typename... T> struct Transitions {};
+
+            template <typename S, typename T, int AbortState = -1>
+            struct Definition;
+
+            template <typename... S, typename... T, int AbortState>
+            struct Definition<States<S...>, Transitions<T...>, AbortState> {
+                enum { size = sizeof...(S), abort_state = AbortState };
+
+                static_assert(sizeof...(S) > 0, "a mission needs a starting state");
+                static_assert(sizeof...(S) <= TRANSITION_TABLE_MAX_STATES, "too many states");
+                static_assert(TransitionTableCheck::mask(S::id...) == TransitionTableCheck::first(sizeof...(S)),
+                              "the state ids must be 0 .. number of states - 1 , each once");
+                static_assert(TransitionTableCheck::all_in(TransitionTableCheck::mask(S::id...), T::origin..., T::dest...),
+                              "a transition goes from or to a state that is not in the table");
+                static_assert((TransitionTableCheck::mask((S::last ? -1 : S::id)...) & ~TransitionTableCheck::mask(T::origin...)) == 0,
+                              "a state that is not last has no transitions , the mission would never leave it");
+                static_assert((TransitionTableCheck::reach(TransitionTableCheck::bit(STARTING_STATE_ID), TransitionTableCheck::edge(T::origin, T::dest)...)
+                               & TransitionTableCheck::mask((S::last ? S::id : -1)...)) != 0,
+                              "no last state can be reached from the starting state , the mission doesn't stop");
+                static_assert((TransitionTableCheck::reach(TransitionTableCheck::bit(STARTING_STATE_ID), TransitionTableCheck::edge(T::origin, T::dest)...)
+                               & ~TransitionTableCheck::reached_by(TransitionTableCheck::mask((S::last ? S::id : -1)...), TransitionTableCheck::edge(T::origin, T::dest)...)) == 0,
+                              "a state can be reached from which no last state can , the mission may never stop");
+                static_assert(AbortState == -1 || (AbortState >= 0 && AbortState < (int) sizeof...(S)),
+                              "the abort state is not in the table");
+
+                static void each_state(const std::function<void(int, bool, StateMachine::st_func, StateMachine::ev_func)>& visit) {
+                    int expand[] = {0, (visit(S::id, S::last, S::function(), S::handler()), 0)...};
+                    (void) expand;
+                }
+
+                static void each_transition(const std::function<void(int, int, StateMachine::tr_func)>& visit) {
+                    int expand[] = {0, (visit(T::origin, T::dest, T::guard()), 0)...};
+                    (void) expand;
+                }
+            };
+        };
+    }
+}
+
+#endif /* transition_table_hpp */
@@ -13,29 +13,63 @@ using namespace boost;
 
 UpDownMission::UpDownMission(double altitude)
 : _altitude(altitude) {
-	_add_state(State(0, "Takeoff", static_cast<StateMachine::st_func>(&UpDownMission::_takeoff)));
-	_add_state(State(1, "Land", static_cast<StateMachine::st_func>(&UpDownMission::_land), true));
-	_add_transition(Transition(0, 1, static_cast<StateMachine::tr_func>(&UpDownMission::_should_transit)));
+	typedef StateTable<UpDownMission> Table;
+	typedef Table::Definition<
+		Table::States<
+			Table::Reacting<0, &UpDownMission::_takeoff>,
+			Table::Reacting<1, &UpDownMission::_land, true>>,
+		Table::Transitions<
+			Table::Transit<0, 1, &UpDownMission::_should_transit>>,
+		1> Definition;
+	static const char* const descriptions[] = {"Takeoff", "Land"};
+	_load<Definition>(descriptions);
 }
 
-bool UpDownMission::_takeoff() {
+// the python calls block till the vehicle got there , they run as commands so an abort doesn't wait for them
+static bool takeoff(double altitude) {
 	bool ret;
 	BEGIN_PYTHON_EXECUTION
-	PyObject* vehicle_control = (PyObject* ) Common::ServiceProvider::get_instance().get_service("vehicle_control");
-	ret = python::call_method<bool>(vehicle_control, "takeoff", _altitude);
+	PyObject* vehicle_control = (PyObject* ) VehicleModule::Common::ServiceProvider::get_instance().get_service("vehicle_control");
+	ret = python::call_method<bool>(vehicle_control, "takeoff", altitude);
 	END_PYTHON_EXECUTION
 	return ret;
 }
 
-bool UpDownMission::_land() {
+static bool land() {
 	bool ret;
 	BEGIN_PYTHON_EXECUTION
-	PyObject* vehicle_control = (PyObject* ) Common::ServiceProvider::get_instance().get_service("vehicle_control");
+	PyObject* vehicle_control = (PyObject* ) VehicleModule::Common::ServiceProvider::get_instance().get_service("vehicle_control");
 	ret = python::call_method<bool>(vehicle_control, "land");
 	END_PYTHON_EXECUTION
 	return ret;
 }
 
+StateMachine::StepResult UpDownMission::_takeoff(const Event& event) {
+	switch (event.type) {
+		case EventType::ENTER: {
+			double altitude = _altitude;
+			_run_command(0, [altitude]() { return takeoff(altitude); });
+			return StepResult::STAY;
+		}
+		case EventType::COMMAND_DONE:
+			return event.succeeded ? StepResult::SUCCEEDED : StepResult::FAILED;
+		default:
+			return StepResult::STAY;
+	}
+}
+
+StateMachine::StepResult UpDownMission::_land(const Event& event) {
+	switch (event.type) {
+		case EventType::ENTER:
+			_run_command(0, land);
+			return StepResult::STAY;
+		case EventType::COMMAND_DONE:
+			return event.succeeded ? StepResult::SUCCEEDED : StepResult::FAILED;
+		default:
+			return StepResult::STAY;
+	}
+}
+
 bool UpDownMission::_should_transit() const {
 	return _last_state_succeed;
 }
@@ -10,6 +10,7 @@
 #define up_down_mission_hpp
 
 #include "state_machine.hpp"
+#include "transition_table.hpp"
 #include "../common/service_provider.hpp"
 #include "thread_locks.hpp"
 #include <thread>
@@ -25,9 +26,9 @@ namespace VehicleModule {
 		private:
 			double _altitude;
 			
-			bool    _takeoff();
-			bool    _land();
-			bool    _should_transit() const;
+			StepResult _takeoff(const Event& event);
+			StepResult _land(const Event& event);
+			bool       _should_transit() const;
 		};
 	}
 }
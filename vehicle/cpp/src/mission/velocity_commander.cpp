@@ -0,0 +1,75 @@
+#include "velocity_commander.hpp"
+#include <boost/python/call_method.hpp>
+#include <boost/python/errors.hpp>
+#include "../common/service_provider.hpp"
+
+using namespace VehicleModule::Mission;
+using namespace VehicleModule::Mavlink;
+using namespace boost;
+
+namespace {
+    // the caller may be a thread that was not started by python , it has no GilLock
+    struct GilState {
+        PyGILState_STATE state;
+        GilState() : state(PyGILState_Ensure()) {}
+        ~GilState() { PyGILState_Release(state); }
+    };
+}
+
+VelocityCommander::VelocityCommander() : _mavlink(nullptr), _failures(0) {}
+
+void VelocityCommander::connect() {
+    _failures = 0;
+    try {
+        MavlinkClient* client = (MavlinkClient*) Common::ServiceProvider::get_instance().get_service(MAVLINK_SERVICE_NAME);
+        _mavlink = client->is_connected() ? client : nullptr;
+    } catch (Common::ServiceProvider::ServiceProviderException&) {
+        _mavlink = nullptr;
+    }
+}
+
+bool VelocityCommander::send(double forward, double right, double down) {
+    if (_mavlink) {
+        _mavlink->set_body_velocity(forward, right, down);
+        return true;
+    }
+    GilState gil;
+    try {
+        PyObject* vehicle_control = (PyObject* ) Common::ServiceProvider::get_instance().get_service("vehicle_control");
+        python::call_method<void>(vehicle_control, "send_ned_velocity", forward, right, down);
+        return true;
+    } catch (python::error_already_set&) {
+        PyErr_Clear();
+        _fail("send_ned_velocity of vehicle_control raised");
+    } catch (std::exception& ex) {
+        _fail(ex.what());
+    }
+    return false;
+}
+
+bool VelocityCommander::hold() {
+    return send(0, 0, 0);
+}
+
+void VelocityCommander::release() {
+    if (_mavlink) {
+        _mavlink->clear_setpoint();
+    }
+}
+
+int VelocityCommander::take_failures(std::string& last_error) {
+    int failures = _failures.exchange(0);
+    if (failures) {
+        std::lock_guard<std::mutex> guard(_error_lock);
+        last_error = _last_error;
+    }
+    return failures;
+}
+
+void VelocityCommander::_fail(const std::string& error) {
+    {
+        std::lock_guard<std::mutex> guard(_error_lock);
+        _last_error = error;
+    }
+    _failures++;
+}
@@ -0,0 +1,55 @@
+#ifndef velocity_commander_hpp
+#define velocity_commander_hpp
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include "../mavlink/mavlink_client.hpp"
+
+/**
+ * sends velocities to the vehicle without blocking , from any thread
+ * through the native MavlinkClient when it is published and the vehicle talks on it , else through
+ * 'send_ned_velocity' of the python vehicle_control . the autopilot drops a velocity after a few seconds
+ * so it must be sent again at least every second (the MavlinkClient does that by itself)
+ * send doesn't throw , a control thread can't handle it . a failed send is counted and the thread that owns
+ * the mission reports it (see take_failures)
+ */
+namespace VehicleModule {
+    namespace Mission {
+        class VelocityCommander {
+        public:
+            VelocityCommander();
+            /**
+             * look for the MavlinkClient again , it may have connected since . the failures are cleared
+             */
+            void connect();
+            bool is_native() const { return _mavlink != nullptr; }
+            /**
+             * @param forward meters per second , relative to the heading of the vehicle
+             * @param right   meters per second
+             * @param down    meters per second
+             * @return false if the velocity could not be sent
+             */
+            bool send(double forward, double right, double down);
+            bool hold();
+            /**
+             * stop streaming the last velocity , to hand the vehicle back to python (land etc.)
+             */
+            void release();
+            /**
+             * @param  last_error the error of the last failed send , if there was one
+             * @return the number of failed sends since the last call
+             */
+            int take_failures(std::string& last_error);
+        private:
+            Mavlink::MavlinkClient* _mavlink;
+            std::atomic<int>        _failures;
+            std::mutex              _error_lock;
+            std::string             _last_error;
+
+            void _fail(const std::string& error);
+        };
+    }
+}
+
+#endif /* velocity_commander_hpp */
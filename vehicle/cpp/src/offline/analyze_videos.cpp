@@ -0,0 +1,363 @@
+//
+//  analyze_videos.cpp
+//  vehicle
+//
+//  runs the bullseye detectors over recorded videos (the .avi files of VideoRecorder) . build with 'make offline'
+//
+//  usage: analyze_videos [--detector name]... [--mode target|direction|both] [--threads count] [--chunk frames]
+//                        [--step frames] [--format csv|binary] [--output path] video...
+//
+//  the videos are decoded and analyzed on a WorkStealingPool : every video is decoded by a chain of tasks that
+//  read 'chunk' frames each and leave the detection of the chunk as another task , so a few long videos keep
+//  all the cores busy as well as many short ones . a decoding task takes the next one only after its worker
+//  is free again , which keeps the decoded frames in memory at about one chunk per worker.
+//
+//  the output has one record per frame , detector and mode , the records of a video are written together
+//  in frame order once the whole video is done.
+//  csv    - header line and then "file,frame,timestamp_ms,detector,mode,found,x,y,radius,confidence,detect_us"
+//  binary - little endian , for hours of footage:
+//           "VDETLOG1" , uint32 number of files , per file uint32 length + path ,
+//           uint32 number of detectors , per detector uint32 length + name , and then OfflineRecord records
+//
+
+#include <opencv2/core/mat.hpp>
+#include <opencv2/videoio.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "detector_registry.hpp"
+#include "work_stealing_pool.hpp"
+
+#define DEFAULT_CHUNK_FRAMES 16
+#define DEFAULT_FPS 15      // what VideoRecorder writes , used when the container doesn't say
+#define BINARY_LOG_MAGIC "VDETLOG1"
+
+using namespace cv;
+using namespace std;
+using namespace VehicleModule::Algorithm;
+using VehicleModule::Common::WorkStealingPool;
+
+#pragma pack(push, 1)
+struct OfflineRecord {
+    uint32_t file;          // index in the file table
+    uint32_t frame;
+    double   timestamp_ms;
+    uint8_t  detector;      // index in the detector table
+    uint8_t  mode;          // 0 TARGET , 1 DIRECTION
+    uint8_t  found;
+    uint8_t  reserved;
+    int32_t  x, y;
+    float    radius;
+    float    confidence;
+    uint32_t detect_us;
+};
+#pragma pack(pop)
+
+struct Options {
+    vector<string>        detectors;
+    vector<DetectionMode> modes;
+    unsigned int          threads;
+    int                   chunk;
+    int                   step;
+    bool                  binary;
+    string                output;
+    vector<string>        files;
+
+    Options() : threads(0), chunk(DEFAULT_CHUNK_FRAMES), step(1), binary(false) {}
+};
+
+struct FrameJob {
+    int    index;
+    double timestamp_ms;
+    Mat    img;
+};
+
+// everything about one video , shared by its decoding and detection tasks
+struct VideoJob {
+    uint32_t              index;
+    VideoCapture          capture;
+    double                fps;
+    int                   next_frame;
+    vector<OfflineRecord> records;
+    mutex                 records_lock;
+    // chunks not analyzed yet plus one while the video is still being decoded , the task that takes it to 0 writes the video
+    atomic<int>           pending;
+};
+
+class Output {
+public:
+    Output(const Options& options) : _options(options), _out(&cout), _frames(0) {
+        if (!_options.output.empty()) {
+            _file.open(_options.output.c_str(), _options.binary ? ios::binary : ios::out);
+            _out = &_file;
+        }
+    }
+
+    bool is_open() const { return _options.output.empty() || _file.is_open(); }
+
+    void write_header() {
+        if (!_options.binary) {
+            *_out << "file,frame,timestamp_ms,detector,mode,found,x,y,radius,confidence,detect_us\n";
+            return;
+        }
+        _out->write(BINARY_LOG_MAGIC, 8);
+        _write_strings(_options.files);
+        _write_strings(_options.detectors);
+    }
+
+    void write(vector<OfflineRecord>& records) {
+        stable_sort(records.begin(), records.end(), [](const OfflineRecord& r1, const OfflineRecord& r2) {
+            return r1.frame < r2.frame;
+        });
+        lock_guard<mutex> guard(_lock);
+        if (_options.binary) {
+            _out->write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(OfflineRecord));
+        } else {
+            char line[512];
+            for (const OfflineRecord& record : records) {
+                snprintf(line, sizeof(line), "%s,%u,%.1f,%s,%s,%d,%d,%d,%.2f,%.3f,%u\n",
+                         _options.files[record.file].c_str(), record.frame, record.timestamp_ms,
+                         _options.detectors[record.detector].c_str(), record.mode ? "direction" : "target",
+                         record.found, record.x, record.y, record.radius, record.confidence, record.detect_us);
+                *_out << line;
+            }
+        }
+        for (const OfflineRecord& record : records) {
+            _detect_us[record.detector * 2 + record.mode] += record.detect_us;
+            _calls[record.detector * 2 + record.mode]++;
+        }
+        _frames += records.size() / (_options.detectors.size() * _options.modes.size());
+    }
+
+    void print_summary(double seconds) {
+        _out->flush();
+        fprintf(stderr, "%zu videos , %lld frames in %.1f s (%.1f frames/s)\n",
+                _options.files.size(), _frames, seconds, seconds > 0 ? _frames / seconds : 0);
+        for (auto& calls : _calls) {
+            fprintf(stderr, "  %-20s %-9s %8.1f us/frame\n", _options.detectors[calls.first / 2].c_str(),
+                    calls.first % 2 ? "direction" : "target", static_cast<double>(_detect_us[calls.first]) / calls.second);
+        }
+    }
+private:
+    const Options&                   _options;
+    ofstream                         _file;
+    ostream*                         _out;
+    mutex                            _lock;
+    long long                        _frames;
+    map<int, long long>              _detect_us, _calls;
+
+    void _write_strings(const vector<string>& strings) {
+        uint32_t count = static_cast<uint32_t>(strings.size());
+        _out->write(reinterpret_cast<const char*>(&count), sizeof(count));
+        for (const string& s : strings) {
+            uint32_t length = static_cast<uint32_t>(s.size());
+            _out->write(reinterpret_cast<const char*>(&length), sizeof(length));
+            _out->write(s.data(), length);
+        }
+    }
+};
+
+static bool parse_options(int argc, char** argv, Options& options) {
+    string mode = "both";
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg.compare(0, 2, "--") != 0) {
+            options.files.push_back(arg);
+            continue;
+        }
+        if (i + 1 >= argc) {
+            cerr << "missing value of " << arg << endl;
+            return false;
+        }
+        string value = argv[++i];
+        if (arg == "--detector") {
+            options.detectors.push_back(value);
+        } else if (arg == "--mode") {
+            mode = value;
+        } else if (arg == "--threads") {
+            options.threads = static_cast<unsigned int>(atoi(value.c_str()));
+        } else if (arg == "--chunk") {
+            options.chunk = max(1, atoi(value.c_str()));
+        } else if (arg == "--step") {
+            options.step = max(1, atoi(value.c_str()));
+        } else if (arg == "--format") {
+            options.binary = value == "binary";
+            if (!options.binary && value != "csv") {
+                cerr << "unknown format " << value << endl;
+                return false;
+            }
+        } else if (arg == "--output") {
+            options.output = value;
+        } else {
+            cerr << "unknown option " << arg << endl;
+            return false;
+        }
+    }
+    if (mode == "target" || mode == "both") {
+        options.modes.push_back(DetectionMode::TARGET);
+    }
+    if (mode == "direction" || mode == "both") {
+        options.modes.push_back(DetectionMode::DIRECTION);
+    }
+    if (options.modes.empty()) {
+        cerr << "unknown mode " << mode << endl;
+        return false;
+    }
+    if (options.detectors.empty()) {
+        options.detectors.push_back(DEFAULT_DETECTOR);
+    }
+    if (options.files.empty()) {
+        cerr << "no videos" << endl;
+        return false;
+    }
+    if (options.binary && options.output.empty()) {
+        cerr << "the binary format needs --output" << endl;
+        return false;
+    }
+    return true;
+}
+
+// engines keep scratch buffers so every worker has its own
+static AbstractDetector& get_detector(const string& name, DetectionMode mode) {
+    static thread_local unordered_map<string, std::shared_ptr<AbstractDetector> > detectors;
+    string key = name + (mode == DetectionMode::TARGET ? "/target" : "/direction");
+    std::shared_ptr<AbstractDetector>& detector = detectors[key];
+    if (!detector) {
+        detector = DetectorRegistry::get_instance().create(name, mode);
+    }
+    return *detector;
+}
+
+static void finish_video(const std::shared_ptr<VideoJob>& video, Output& output) {
+    video->capture.release();
+    output.write(video->records);
+    video->records = vector<OfflineRecord>();
+}
+
+static void analyze_chunk(const std::shared_ptr<VideoJob>& video, const std::shared_ptr<vector<FrameJob> >& chunk,
+                          const Options& options, Output& output) {
+    vector<OfflineRecord> records;
+    records.reserve(chunk->size() * options.detectors.size() * options.modes.size());
+    for (const FrameJob& frame : *chunk) {
+        for (size_t d = 0; d < options.detectors.size(); d++) {
+            for (DetectionMode mode : options.modes) {
+                BullseyeResult result;
+                auto start = chrono::steady_clock::now();
+                get_detector(options.detectors[d], mode).find(frame.img, result);
+                auto elapsed = chrono::steady_clock::now() - start;
+
+                OfflineRecord record = {};
+                record.file = video->index;
+                record.frame = static_cast<uint32_t>(frame.index);
+                record.timestamp_ms = frame.timestamp_ms;
+                record.detector = static_cast<uint8_t>(d);
+                record.mode = mode == DetectionMode::TARGET ? 0 : 1;
+                record.found = result.found;
+                record.x = result.center.x;
+                record.y = result.center.y;
+                record.radius = static_cast<float>(result.radius);
+                record.confidence = static_cast<float>(result.confidence);
+                record.detect_us = static_cast<uint32_t>(chrono::duration_cast<chrono::microseconds>(elapsed).count());
+                records.push_back(record);
+            }
+        }
+    }
+    {
+        lock_guard<mutex> guard(video->records_lock);
+        video->records.insert(video->records.end(), records.begin(), records.end());
+    }
+    if (--video->pending == 0) {
+        finish_video(video, output);
+    }
+}
+
+static void decode_chunk(const std::shared_ptr<VideoJob>& video, const Options& options, Output& output, WorkStealingPool& pool) {
+    std::shared_ptr<vector<FrameJob> > chunk = std::make_shared<vector<FrameJob> >();
+    while (static_cast<int>(chunk->size()) < options.chunk) {
+        // the skipped frames are only demuxed , not decoded
+        bool skipped = true;
+        for (int i = 1; i < options.step && skipped; i++, video->next_frame++) {
+            skipped = video->capture.grab();
+        }
+        FrameJob frame;
+        if (!skipped || !video->capture.read(frame.img) || frame.img.empty()) {
+            break;
+        }
+        frame.index = video->next_frame++;
+        frame.timestamp_ms = frame.index * 1000.0 / video->fps;
+        chunk->push_back(frame);
+    }
+
+    if (chunk->empty()) {
+        if (--video->pending == 0) {
+            finish_video(video, output);
+        }
+        return;
+    }
+    video->pending++;
+    // the worker takes the chunk first (last in , first out) and the rest of the video is left to be stolen
+    pool.submit([video, &options, &output, &pool]() { decode_chunk(video, options, output, pool); });
+    pool.submit([video, chunk, &options, &output]() { analyze_chunk(video, chunk, options, output); });
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        return 1;
+    }
+    try {
+        for (const string& name : options.detectors) {
+            DetectorRegistry::get_instance().create(name, DetectionMode::TARGET);
+        }
+    } catch (const DetectorRegistry::DetectorRegistryException& e) {
+        cerr << e.message << endl;
+        return 1;
+    }
+
+    vector<std::shared_ptr<VideoJob> > videos;
+    for (size_t i = 0; i < options.files.size(); i++) {
+        std::shared_ptr<VideoJob> video = std::make_shared<VideoJob>();
+        video->index = static_cast<uint32_t>(i);
+        if (!video->capture.open(options.files[i])) {
+            cerr << "can't open video " << options.files[i] << endl;
+            return 1;
+        }
+        video->fps = video->capture.get(CV_CAP_PROP_FPS);
+        if (video->fps <= 0) {
+            video->fps = DEFAULT_FPS;
+        }
+        video->next_frame = 0;
+        video->pending = 1;
+        videos.push_back(video);
+    }
+
+    Output output(options);
+    if (!output.is_open()) {
+        cerr << "can't open output " << options.output << endl;
+        return 1;
+    }
+    output.write_header();
+
+    auto start = chrono::steady_clock::now();
+    {
+        WorkStealingPool pool(options.threads);
+        for (const std::shared_ptr<VideoJob>& video : videos) {
+            pool.submit([video, &options, &output, &pool]() { decode_chunk(video, options, output, pool); });
+        }
+        pool.wait();
+    }
+    double seconds = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count() / 1000.0;
+    output.print_summary(seconds);
+    return 0;
+}
@@ -17,6 +17,8 @@
 #include "mission/find_and_land_mission.hpp"
 #include "mission/up_down_mission.hpp"
 #include "common/service_provider.hpp"
+#include "common/telemetry_store.hpp"
+#include "mavlink/mavlink_client.hpp"
 #include "video/video_provider.hpp"
 #include "video/video_streamer.hpp"
 #include "video/video_recorder.hpp"
@@ -27,6 +29,7 @@ using namespace boost;
 using namespace VehicleModule::Common;
 using namespace VehicleModule::Mission;
 using namespace VehicleModule::Video;
+using namespace VehicleModule::Mavlink;
 
 void translate_vehicle_module_exception(const VehicleModuleException& ex) {
     PyErr_SetString(PyExc_RuntimeError, ex.what());
@@ -34,20 +37,25 @@ void translate_vehicle_module_exception(const VehicleModuleException& ex) {
 
 BOOST_PYTHON_MODULE(libvehicle)
 {
-    python::class_<DemoMission>("DemoMission", python::init<double, double, double>())
-    .def("start", &DemoMission::start);
+    python::class_<DemoMission, boost::noncopyable>("DemoMission", python::init<double, double, double>())
+    .def("start", &DemoMission::start)
+    .def("abort", &DemoMission::abort);
 
-    python::class_<CoarseScanMission>("CoarseScanMission", python::init<double, double, double>())
-    .def("start", &CoarseScanMission::start);
+    python::class_<CoarseScanMission, boost::noncopyable>("CoarseScanMission", python::init<double, double, double, python::optional<std::string> >())
+    .def("start", &CoarseScanMission::start)
+    .def("abort", &CoarseScanMission::abort);
 
-    python::class_<FindAndLandMission>("FindAndLandMission", python::init<double, double, double>())
-    .def("start", &FindAndLandMission::start);
+    python::class_<FindAndLandMission, boost::noncopyable>("FindAndLandMission", python::init<double, double, double, python::optional<std::string, double> >())
+    .def("start", &FindAndLandMission::start)
+    .def("abort", &FindAndLandMission::abort);
 
-    python::class_<UpDownMission>("UpDownMission", python::init<double>())
-    .def("start", &UpDownMission::start);
+    python::class_<UpDownMission, boost::noncopyable>("UpDownMission", python::init<double>())
+    .def("start", &UpDownMission::start)
+    .def("abort", &UpDownMission::abort);
 
-    python::class_<AnalyzeImageMission>("AnalyzeImageMission", python::init<>())
-    .def("start", &AnalyzeImageMission::start);
+    python::class_<AnalyzeImageMission, boost::noncopyable>("AnalyzeImageMission", python::init<>())
+    .def("start", &AnalyzeImageMission::start)
+    .def("abort", &AnalyzeImageMission::abort);
 
     void (ServiceProvider::*publish_python)(const std::string& , PyObject* )  = &ServiceProvider::publish;
 
@@ -56,6 +64,17 @@ BOOST_PYTHON_MODULE(libvehicle)
     .def("get_instance", &ServiceProvider::get_instance, python::return_value_policy<python::reference_existing_object>())
     .staticmethod("get_instance");
 
+    python::class_<TelemetryStore, boost::noncopyable>("TelemetryStore", python::no_init)
+    .def("update", &TelemetryStore::update_from_python)
+    .def("get_instance", &TelemetryStore::get_instance, python::return_value_policy<python::reference_existing_object>())
+    .staticmethod("get_instance");
+
+    python::class_<MavlinkClient, boost::noncopyable>("MavlinkClient", python::init<std::string, int >())
+    .def("start", &MavlinkClient::start)
+    .def("stop", &MavlinkClient::stop)
+    .def("is_connected", &MavlinkClient::is_connected)
+    .def("publish_as_cpp_service", &MavlinkClient::publish_as_cpp_service);
+
     python::class_<VideoProvider, boost::noncopyable>("VideoProvider", python::no_init)
     .def("start_listen_to_camera", &VideoProvider::start_listen_to_camera)
     .def("stop_listen_to_camera", &VideoProvider::stop_listen_to_camera)
@@ -0,0 +1,242 @@
+//
+//  mavlink_codec_test.cpp
+//  vehicle
+//
+//  the MAVLink encoder and parser against frames written out by hand . build and run with 'make test'
+//
+//  the frames were made from the MAVLink spec (little endian payload with the fields sorted by size , X.25 crc
+//  over everything after the start byte and then the crc extra of the message) , not with this codec
+//
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "../mavlink/mavlink_codec.hpp"
+
+using namespace VehicleModule::Mavlink;
+using namespace std;
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            printf("%s:%d: failed: %s\n", __FILE__, __LINE__, #condition); \
+            failures++; \
+        } \
+    } while (0)
+
+// ArduCopter heartbeat , seq 7 , system 1 , component 1 : custom mode 4 (guided) , quadrotor , ardupilotmega , armed
+static const uint8_t HEARTBEAT_V1[] = {
+    0xFE, 0x09, 0x07, 0x01, 0x01, 0x00, 0x04, 0x00, 0x00, 0x00, 0x02, 0x03, 0xD9, 0x04, 0x03, 0xD0, 0xD5
+};
+// the same heartbeat as MAVLink 2 , seq 8
+static const uint8_t HEARTBEAT_V2[] = {
+    0xFD, 0x09, 0x00, 0x00, 0x08, 0x01, 0x01, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x02, 0x03, 0xD9, 0x04,
+    0x03, 0x09, 0x36
+};
+// signed MAVLink 2 attitude , seq 9 : roll 0.25 pitch -0.5 yaw 1.5 , the trailing zero rates are cut off
+static const uint8_t SIGNED_ATTITUDE_V2[] = {
+    0xFD, 0x10, 0x01, 0x00, 0x09, 0x01, 0x01, 0x1E, 0x00, 0x00, 0xE8, 0x03, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3E,
+    0x00, 0x00, 0x00, 0xBF, 0x00, 0x00, 0xC0, 0x3F, 0x54, 0xA9,
+    0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D      // signature
+};
+// downward rangefinder , seq 10 : 1.5 m of 0.2 .. 40 m
+static const uint8_t DISTANCE_SENSOR_V1[] = {
+    0xFE, 0x0E, 0x0A, 0x01, 0x01, 0x84, 0xD0, 0x07, 0x00, 0x00, 0x14, 0x00, 0xA0, 0x0F, 0x96, 0x00, 0x00, 0x01,
+    0x19, 0x00, 0x96, 0xC4
+};
+// what Encoder(MAVLINK_SYSTEM_ID , MAVLINK_COMPONENT_ID) sends first : its heartbeat and then a body velocity
+static const uint8_t GCS_HEARTBEAT_V1[] = {
+    0xFE, 0x09, 0x00, 0xFF, 0xBE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x08, 0x00, 0x00, 0x03, 0x28, 0x42
+};
+static const uint8_t BODY_VELOCITY_V1[] = {
+    0xFE, 0x35, 0x01, 0xFF, 0xBE, 0x54, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x00, 0xC0, 0x00, 0x00, 0x00, 0x3F, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xC7, 0x0D, 0x01, 0x01, 0x08, 0x05, 0xD6
+};
+
+// the messages completed by the bytes
+static vector<Message> feed(Parser& parser, const uint8_t* bytes, size_t length) {
+    vector<Message> messages;
+    Message message;
+    for (size_t i = 0; i < length; i++) {
+        if (parser.parse(bytes[i], message)) {
+            messages.push_back(message);
+        }
+    }
+    return messages;
+}
+
+template <size_t N>
+static vector<Message> feed(Parser& parser, const uint8_t (&bytes)[N]) {
+    return feed(parser, bytes, N);
+}
+
+static void check_heartbeat(const Message& message, uint8_t sequence) {
+    Heartbeat heartbeat;
+    CHECK(message.id == MAVLINK_MSG_HEARTBEAT);
+    CHECK(message.system_id == 1 && message.component_id == 1 && message.sequence == sequence);
+    CHECK(decode(message, heartbeat));
+    CHECK(heartbeat.custom_mode == 4);
+    CHECK(heartbeat.type == 2 && heartbeat.autopilot == 3 && heartbeat.system_status == 4);
+    CHECK(heartbeat.base_mode & MAV_MODE_FLAG_SAFETY_ARMED);
+}
+
+static void test_crc() {
+    // the check value of CRC-16/MCRF4XX , which is the crc of MAVLink
+    const char* check = "123456789";
+    uint16_t crc = 0xFFFF;
+    for (const char* c = check; *c; c++) {
+        crc = crc_accumulate(static_cast<uint8_t>(*c), crc);
+    }
+    CHECK(crc == 0x6F91);
+}
+
+static void test_encoder() {
+    Encoder encoder(255, 190);
+    vector<uint8_t> out;
+    encoder.heartbeat(out);
+    CHECK(out == vector<uint8_t>(GCS_HEARTBEAT_V1, GCS_HEARTBEAT_V1 + sizeof(GCS_HEARTBEAT_V1)));
+
+    PositionTarget target;
+    memset(&target, 0, sizeof(target));
+    target.velocity[0] = 1;
+    target.velocity[1] = -2;
+    target.velocity[2] = 0.5;
+    target.type_mask = MAVLINK_IGNORE_POSITION | MAVLINK_IGNORE_ACCELERATION | MAVLINK_IGNORE_YAW;
+    target.target_system = 1;
+    target.target_component = 1;
+    target.frame = MAV_FRAME_BODY_NED;
+    encoder.position_target(target, out);
+    CHECK(out == vector<uint8_t>(BODY_VELOCITY_V1, BODY_VELOCITY_V1 + sizeof(BODY_VELOCITY_V1)));
+}
+
+static void test_round_trip() {
+    // what the encoder sends parses back to the same fields
+    Encoder encoder(255, 190);
+    Parser parser;
+    vector<uint8_t> out;
+    encoder.heartbeat(out);
+    vector<Message> messages = feed(parser, out.data(), out.size());
+    Heartbeat heartbeat;
+    CHECK(messages.size() == 1);
+    CHECK(messages.size() == 1 && decode(messages[0], heartbeat) && heartbeat.type == MAV_TYPE_GCS);
+    CHECK(messages.size() == 1 && messages[0].system_id == 255 && messages[0].component_id == 190);
+
+    PositionTarget target;
+    memset(&target, 0, sizeof(target));
+    target.velocity[1] = -2;
+    encoder.position_target(target, out);
+    messages = feed(parser, out.data(), out.size());
+    float east;
+    CHECK(messages.size() == 1 && messages[0].id == MAVLINK_MSG_SET_POSITION_TARGET_LOCAL_NED);
+    CHECK(messages.size() == 1 && messages[0].sequence == 1);
+    if (messages.size() == 1) {
+        memcpy(&east, messages[0].payload + 20, sizeof(east));
+        CHECK(east == -2);
+    }
+    CHECK(parser.get_crc_errors() == 0);
+}
+
+static void test_v1() {
+    Parser parser;
+    vector<Message> messages = feed(parser, HEARTBEAT_V1);
+    CHECK(messages.size() == 1);
+    if (messages.size() == 1) {
+        check_heartbeat(messages[0], 7);
+    }
+
+    messages = feed(parser, DISTANCE_SENSOR_V1);
+    DistanceSensor distance;
+    CHECK(messages.size() == 1 && decode(messages[0], distance));
+    CHECK(messages.size() == 1 && distance.current_distance == 150 && distance.min_distance == 20 && distance.max_distance == 4000);
+    CHECK(messages.size() == 1 && distance.orientation == 25);
+}
+
+static void test_v2() {
+    Parser parser;
+    vector<Message> messages = feed(parser, HEARTBEAT_V2);
+    CHECK(messages.size() == 1);
+    if (messages.size() == 1) {
+        check_heartbeat(messages[0], 8);
+    }
+}
+
+static void test_signed_v2() {
+    // the signature is skipped , its bytes are not taken for the start of a frame and the next frame is parsed
+    Parser parser;
+    vector<uint8_t> stream(SIGNED_ATTITUDE_V2, SIGNED_ATTITUDE_V2 + sizeof(SIGNED_ATTITUDE_V2));
+    stream.insert(stream.end(), HEARTBEAT_V1, HEARTBEAT_V1 + sizeof(HEARTBEAT_V1));
+    vector<Message> messages = feed(parser, stream.data(), stream.size());
+    Attitude attitude;
+    CHECK(messages.size() == 2);
+    CHECK(messages.size() == 2 && decode(messages[0], attitude));
+    CHECK(messages.size() == 2 && attitude.time_boot_ms == 1000 && attitude.roll == 0.25f && attitude.pitch == -0.5f && attitude.yaw == 1.5f);
+    CHECK(messages.size() == 2 && messages[1].id == MAVLINK_MSG_HEARTBEAT);
+}
+
+static void test_split() {
+    // a frame split between datagrams at every byte , with noise before it
+    for (size_t split = 1; split < sizeof(HEARTBEAT_V2); split++) {
+        Parser parser;
+        const uint8_t noise[] = {0x00, 0x42, 0x13};
+        vector<Message> messages = feed(parser, noise);
+        CHECK(messages.empty());
+        messages = feed(parser, HEARTBEAT_V2, split);
+        CHECK(messages.empty());
+        messages = feed(parser, HEARTBEAT_V2 + split, sizeof(HEARTBEAT_V2) - split);
+        CHECK(messages.size() == 1);
+        if (messages.size() == 1) {
+            check_heartbeat(messages[0], 8);
+        }
+    }
+
+    // two frames in one datagram
+    Parser parser;
+    vector<uint8_t> stream(HEARTBEAT_V1, HEARTBEAT_V1 + sizeof(HEARTBEAT_V1));
+    stream.insert(stream.end(), DISTANCE_SENSOR_V1, DISTANCE_SENSOR_V1 + sizeof(DISTANCE_SENSOR_V1));
+    CHECK(feed(parser, stream.data(), stream.size()).size() == 2);
+}
+
+static void test_bad_crc() {
+    Parser parser;
+    uint8_t corrupted[sizeof(HEARTBEAT_V1)];
+    memcpy(corrupted, HEARTBEAT_V1, sizeof(corrupted));
+    corrupted[12] ^= 0x01;      // base mode
+    CHECK(feed(parser, corrupted).empty());
+    CHECK(parser.get_crc_errors() == 1);
+
+    memcpy(corrupted, HEARTBEAT_V1, sizeof(corrupted));
+    corrupted[sizeof(corrupted) - 1] ^= 0xFF;       // the crc itself
+    CHECK(feed(parser, corrupted).empty());
+    CHECK(parser.get_crc_errors() == 2);
+
+    // the parser goes on with the next frame
+    CHECK(feed(parser, HEARTBEAT_V2).size() == 1);
+
+    // a message we don't know can't be checked , it is dropped without counting an error
+    uint8_t unknown[sizeof(HEARTBEAT_V1)];
+    memcpy(unknown, HEARTBEAT_V1, sizeof(unknown));
+    unknown[5] = 1;     // SYS_STATUS
+    CHECK(feed(parser, unknown).empty());
+    CHECK(parser.get_crc_errors() == 2);
+}
+
+int main() {
+    test_crc();
+    test_encoder();
+    test_round_trip();
+    test_v1();
+    test_v2();
+    test_signed_v2();
+    test_split();
+    test_bad_crc();
+    if (failures) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("mavlink codec: ok\n");
+    return 0;
+}
@@ -0,0 +1,222 @@
+//
+//  state_machine_test.cpp
+//  vehicle
+//
+//  the order in which a StateMachine hands its events to the states . build and run with 'make test'
+//
+//  the missions below run on the real Executor without a camera or a vehicle . the engine logs through the
+//  python logger service , so the test starts an interpreter and publishes a logger that drops everything
+//
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "../mission/state_machine.hpp"
+#include "../common/service_provider.hpp"
+
+using namespace VehicleModule;
+using namespace VehicleModule::Mission;
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            printf("%s:%d: failed: %s\n", __FILE__, __LINE__, #condition); \
+            failures++; \
+        } \
+    } while (0)
+
+// the engine only adds and removes listeners of the service , the test has no camera to run a real one
+int Algorithm::DetectionService::add_listener(const Listener&) { return 0; }
+void Algorithm::DetectionService::remove_listener(int) {}
+
+/**
+ * a command that outlives its state , its COMMAND_DONE must not reach the next state
+ */
+class StaleCommandMission : public StateMachine {
+public:
+    int next_state_commands;
+
+    StaleCommandMission() : next_state_commands(0) {
+        _add_state(State(0, "Command", static_cast<ev_func>(&StaleCommandMission::_command)));
+        _add_state(State(1, "Next", static_cast<ev_func>(&StaleCommandMission::_next), true));
+        _add_transition(Transition(0, 1, static_cast<tr_func>(&StaleCommandMission::_succeeded)));
+    }
+private:
+    StepResult _command(const Event& event) {
+        if (event.type == EventType::ENTER) {
+            _run_command(1, []() { std::this_thread::sleep_for(std::chrono::milliseconds(200)); return true; });
+            _start_timer(1, 50);
+        }
+        return event.type == EventType::TIMER ? StepResult::SUCCEEDED : StepResult::STAY;
+    }
+    StepResult _next(const Event& event) {
+        if (event.type == EventType::ENTER) {
+            _start_timer(2, 400);
+        } else if (event.type == EventType::COMMAND_DONE) {
+            next_state_commands++;
+        }
+        return event.type == EventType::TIMER ? StepResult::SUCCEEDED : StepResult::STAY;
+    }
+    bool _succeeded() const { return _last_state_succeed; }
+};
+
+/**
+ * an abort before start , the mission runs only its abort state (if it has one)
+ */
+class AbortBeforeStartMission : public StateMachine {
+public:
+    bool started, abort_state_entered;
+
+    AbortBeforeStartMission(bool with_abort_state) : started(false), abort_state_entered(false) {
+        _add_state(State(0, "Start", static_cast<ev_func>(&AbortBeforeStartMission::_start), true));
+        _add_state(State(1, "Abort", static_cast<ev_func>(&AbortBeforeStartMission::_abort_state), true));
+        if (with_abort_state) {
+            _set_abort_state(1);
+        }
+    }
+private:
+    StepResult _start(const Event& event) {
+        started = true;
+        return StepResult::SUCCEEDED;
+    }
+    StepResult _abort_state(const Event& event) {
+        abort_state_entered = true;
+        return StepResult::SUCCEEDED;
+    }
+};
+
+/**
+ * an abort while events wait for the state , the state gets the abort next and the abort state starts with ENTER
+ */
+class AbortAheadMission : public StateMachine {
+public:
+    std::vector<EventType> busy_events, abort_state_events;
+
+    AbortAheadMission() {
+        _add_state(State(0, "Busy", static_cast<ev_func>(&AbortAheadMission::_busy), true));
+        _add_state(State(1, "Abort", static_cast<ev_func>(&AbortAheadMission::_abort_state), true));
+        _set_abort_state(1);
+    }
+private:
+    StepResult _busy(const Event& event) {
+        busy_events.push_back(event.type);
+        if (event.type == EventType::ENTER) {
+            for (int i = 0; i < 3; i++) {
+                post_event(Event(EventType::FRAME_READY));
+            }
+            abort();
+        }
+        return StepResult::STAY;
+    }
+    StepResult _abort_state(const Event& event) {
+        abort_state_events.push_back(event.type);
+        return StepResult::SUCCEEDED;
+    }
+};
+
+/**
+ * a timer of a state that was left fires , also when the state was entered again
+ */
+class LateTimerMission : public StateMachine {
+public:
+    int entries;
+    std::vector<int> timers, next_state_timers;
+
+    LateTimerMission() : entries(0) {
+        _add_state(State(0, "First", static_cast<ev_func>(&LateTimerMission::_first)));
+        _add_state(State(1, "Next", static_cast<ev_func>(&LateTimerMission::_next), true));
+        _add_transition(Transition(0, 1, static_cast<tr_func>(&LateTimerMission::_succeeded)));
+    }
+private:
+    StepResult _first(const Event& event) {
+        if (event.type == EventType::TIMER) {
+            timers.push_back(event.id);
+            return StepResult::SUCCEEDED;
+        }
+        if (event.type != EventType::ENTER) {
+            return StepResult::STAY;
+        }
+        if (++entries == 1) {
+            // fails right away , no transition fires and the state is entered again
+            _start_timer(1, 100);
+            return StepResult::FAILED;
+        }
+        _start_timer(2, 200);
+        return StepResult::STAY;
+    }
+    StepResult _next(const Event& event) {
+        if (event.type == EventType::ENTER) {
+            _start_timer(3, 300);
+            return StepResult::STAY;
+        }
+        if (event.type == EventType::TIMER) {
+            next_state_timers.push_back(event.id);
+        }
+        return event.type == EventType::TIMER && event.id == 3 ? StepResult::SUCCEEDED : StepResult::STAY;
+    }
+    bool _succeeded() const { return _last_state_succeed; }
+};
+
+static void test_stale_command() {
+    StaleCommandMission mission;
+    mission.start();
+    CHECK(mission.next_state_commands == 0);
+}
+
+static void test_abort_before_start() {
+    AbortBeforeStartMission with_abort_state(true);
+    with_abort_state.abort();
+    with_abort_state.start();
+    CHECK(!with_abort_state.started);
+    CHECK(with_abort_state.abort_state_entered);
+
+    AbortBeforeStartMission without_abort_state(false);
+    without_abort_state.abort();
+    without_abort_state.start();
+    CHECK(!without_abort_state.started);
+    CHECK(!without_abort_state.abort_state_entered);
+}
+
+static void test_abort_ahead_of_queued_events() {
+    AbortAheadMission mission;
+    mission.start();
+    CHECK(mission.busy_events.size() == 2);
+    CHECK(mission.busy_events.size() == 2 && mission.busy_events[1] == EventType::ABORT);
+    CHECK(!mission.abort_state_events.empty() && mission.abort_state_events[0] == EventType::ENTER);
+}
+
+static void test_late_timer() {
+    LateTimerMission mission;
+    mission.start();
+    CHECK(mission.entries == 2);
+    CHECK(mission.timers.size() == 1 && mission.timers[0] == 2);
+    CHECK(mission.next_state_timers.size() == 1 && mission.next_state_timers[0] == 3);
+}
+
+int main() {
+    Py_Initialize();
+#if PY_MAJOR_VERSION < 3
+    PyEval_InitThreads();
+#endif
+    PyRun_SimpleString("class Logger(object):\n"
+                       "    def _drop(self, *args):\n"
+                       "        pass\n"
+                       "    info = warn = critical = debug = state = _drop\n"
+                       "logger = Logger()\n");
+    PyObject* logger = PyObject_GetAttrString(PyImport_AddModule("__main__"), "logger");
+    VehicleModule::Common::ServiceProvider::get_instance().publish("logger", logger);
+
+    test_stale_command();
+    test_abort_before_start();
+    test_abort_ahead_of_queued_events();
+    test_late_timer();
+    if (failures) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("state machine: ok\n");
+    return 0;
+}
@@ -71,6 +71,7 @@ void VideoProvider::start_listen_to_camera(){
             struct timeval tp;
             gettimeofday(&tp, NULL);
             _current_frame_timestamp = tp.tv_sec * 1000 + tp.tv_usec / 1000;
+            _current_frame_sequence++;
         _read_write_lock.write_unlock();
         if(first_run){
             //Got the first frame and now the video provider able to supply frames to readers
@@ -113,10 +114,29 @@ return : the return value is the frame`s timestamp e.g when the frame was pulled
          0 if error occur or we haven`t fetched any frame from camera
 */
 bool VideoProvider::get_frame(cv::Mat& frame , Channel channel){
+    return _get_frame(frame, channel, nullptr, nullptr);
+}
+bool VideoProvider::get_frame(cv::Mat& frame , Channel channel,long long& image_timestamp){
+    return _get_frame(frame, channel, &image_timestamp, nullptr);
+}
+bool VideoProvider::get_frame(cv::Mat& frame , Channel channel,long long& image_timestamp,long long& frame_sequence){
+    return _get_frame(frame, channel, &image_timestamp, &frame_sequence);
+}
+bool VideoProvider::get_frame_telemetry(long long image_timestamp , Common::Telemetry& telemetry) const{
+    return Common::TelemetryHistory::get_instance().try_get_at(image_timestamp, telemetry);
+}
+bool VideoProvider::_get_frame(cv::Mat& frame , Channel channel,long long* image_timestamp,long long* frame_sequence){
     if(_running.load())
     {
+        //the timestamp and the sequence are read under the same lock as the frame so they always belong to it
         _read_write_lock.read_lock();
         frame = _frames[_current_frame].clone();
+        if(image_timestamp){
+            *image_timestamp = _current_frame_timestamp;
+        }
+        if(frame_sequence){
+            *frame_sequence = _current_frame_sequence;
+        }
         _read_write_lock.read_unlock();
         if(channel != Channel::DEFAULT)
         {
@@ -138,15 +158,6 @@ bool VideoProvider::get_frame(cv::Mat& frame , Channel channel){
     }
     return false;
 }
-bool VideoProvider::get_frame(cv::Mat& frame , Channel channel,long long& image_timestamp){
-    bool got_frame = VideoProvider::get_frame(frame,channel);
-    if(got_frame){
-        _read_write_lock.read_lock();
-        image_timestamp = _current_frame_timestamp;
-        _read_write_lock.read_unlock();
-    }
-    return got_frame;
-}
 
 void VideoProvider::set_channel(Channel channel,const Modifiers::Collection & collection)
 {
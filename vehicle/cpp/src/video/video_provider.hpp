@@ -14,6 +14,7 @@
 #include <chrono>
 #include "../common/logger.hpp"
 #include "../common/vehicle_module_exception.hpp"
+#include "../common/telemetry_history.hpp"
 #include "rw_lock.hpp"
 #include "gil_lock.hpp"
 #include "clock.hpp"
@@ -73,15 +74,17 @@ namespace VehicleModule {
             int                     _height;
             int                     _codec_type;
             long long               _current_frame_timestamp;
+            long long               _current_frame_sequence;
             ::Common::RWLock        _channels_read_write_lock;
             std::unordered_map<Channel, Modifiers::Collection , ChannelHash> _channels;
             VideoProvider():
             _camera(),_read_write_lock(),
-            _frames(),_current_frame(0),
+            _frames(),_current_frame(0),_current_frame_timestamp(0),_current_frame_sequence(0),
             _running(false),_width(0),_height(0),_codec_type(0),
             _channels(),_channels_read_write_lock()
             { };
             void _stop_listen_to_camera();
+            bool _get_frame(cv::Mat& frame, Channel channel, long long* image_timestamp, long long* frame_sequence);
         public:
             static VideoProvider& get_instance() {
                 static VideoProvider instance;
@@ -123,6 +126,19 @@ namespace VehicleModule {
             */
             bool get_frame(cv::Mat& frame, Channel channel , long long & image_timestamp );
             /**
+            * same as get_frame with timestamp and also gives the number of the frame since the camera started
+            * @param frame_sequence  increases by one for every frame we got from camera , consumers that skip frames can tell how many they skipped
+            */
+            bool get_frame(cv::Mat& frame, Channel channel , long long & image_timestamp , long long & frame_sequence);
+            /**
+            * the state of the vehicle when a frame was captured , interpolated from the TelemetryHistory
+            * the later it is called the more accurate it is (the snapshot after the capture may not have arrived yet)
+            * @param image_timestamp the timestamp get_frame gave for the frame
+            * @param telemetry       altitude , attitude and position of the vehicle at that time
+            * @return false if there is no telemetry around that time
+            */
+            bool get_frame_telemetry(long long image_timestamp , Common::Telemetry& telemetry) const;
+            /**
             * add collection to channel collection contains filters masks and transformations see the modifiers folder for more info
             * @param Channel 2 channels exists DEFAULT and DEBUG DEFAULT provides the original frame and DEBUG apply the collection of modifiers if we loaded the with this function
             *                Note : you cannot load collection to the DEFAULT channel if you need diffrent channel other then DEBUG just create one
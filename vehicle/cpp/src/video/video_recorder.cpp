@@ -33,13 +33,23 @@ void VideoRecorder::start_recording_video()
         Common::Logger::critical("Cannot open video recorder",VIDEO_RECORDER_TAG);
         throw VideoRecorderException("Cannot open video recorder");
     }
+    std::ofstream telemetry_stream(_filename.substr(0, _filename.rfind('.')) + VIDEO_RECORDER_TELEMETRY_EXTENSION);
+    telemetry_stream.precision(10);     // degrees of latitude need more than the 6 digits
+    telemetry_stream << "sequence,timestamp,roll,pitch,yaw,altitude,rangefinder,latitude,longitude,velocity_north,velocity_east,velocity_down" << std::endl;
     Common::Logger::info("Strat recording video",VIDEO_RECORDER_TAG);
     bool already_warned = false;
+    // the telemetry of a frame is written with the next frame , by then the snapshot after its capture arrived
+    long long pending_sequence = 0, pending_timestamp = 0;
     while(_running.load()){
-        long long frame_timestamp = 0;
-        if(provider.get_frame(frame,VideoProvider::Channel::DEFAULT,frame_timestamp))
+        long long frame_timestamp = 0, frame_sequence = 0;
+        if(provider.get_frame(frame,VideoProvider::Channel::DEFAULT,frame_timestamp,frame_sequence))
         {
             video_writer.write(frame);
+            if(pending_timestamp){
+                _write_telemetry(telemetry_stream, pending_sequence, pending_timestamp);
+            }
+            pending_sequence = frame_sequence;
+            pending_timestamp = frame_timestamp;
             already_warned = false;
         }
         else
@@ -54,10 +64,26 @@ void VideoRecorder::start_recording_video()
             provider.wait_to_next_frame();
         }
     }
+    if(pending_timestamp){
+        _write_telemetry(telemetry_stream, pending_sequence, pending_timestamp);
+    }
     Common::Logger::info("Stop recording video",VIDEO_RECORDER_TAG);
     video_writer.release();
 }
 
+void VideoRecorder::_write_telemetry(std::ofstream& stream, long long frame_sequence, long long frame_timestamp){
+    stream << frame_sequence << "," << frame_timestamp;
+    Common::Telemetry telemetry;
+    if(VideoProvider::get_instance().get_frame_telemetry(frame_timestamp, telemetry)){
+        stream << "," << telemetry.roll << "," << telemetry.pitch << "," << telemetry.yaw << "," << telemetry.altitude << "," << telemetry.rangefinder
+               << "," << telemetry.latitude << "," << telemetry.longitude
+               << "," << telemetry.velocity[0] << "," << telemetry.velocity[1] << "," << telemetry.velocity[2];
+    }else{
+        stream << ",,,,,,,,,,";
+    }
+    stream << "\n";
+}
+
 void VideoRecorder::stop_recording_video(){
     ::Common::GilLock lk;
     lk.unlock();
@@ -3,6 +3,7 @@
 #include <atomic>
 #include <mutex>
 #include <chrono>
+#include <fstream>
 #include <opencv2/videoio.hpp>
 #include "gil_lock.hpp"
 #include "video_provider.hpp"
@@ -10,8 +11,11 @@
 #include "../common/vehicle_module_exception.hpp"
 
 #define VIDEO_RECORDER_TAG "VideoRecoder"
+#define VIDEO_RECORDER_TELEMETRY_EXTENSION ".telemetry.csv"
 /**
  * recording the video to file with avi extension
+ * next to it a csv gets the state of the vehicle at the capture time of every recorded frame (a line per frame ,
+ * empty fields when there was no telemetry) so the video can be analyzed offline with the right geometry
  */
 namespace VehicleModule {
     namespace Video{
@@ -21,6 +25,7 @@ namespace VehicleModule {
             std::mutex                       _owner_lock;
             std::string                      _filename;
             void _stop_recording_video();
+            void _write_telemetry(std::ofstream& stream, long long frame_sequence, long long frame_timestamp);
         public:
             VideoRecorder(const std::string& filename):
             _running(false),
@@ -7,10 +7,11 @@ import vehicle.cpp.build.libvehicle as libvehicle
 from vehicle.cpp.build.libvehicle import ServiceProvider
 from vehicle.cpp.build.libvehicle import DemoMission, CoarseScanMission, UpDownMission, AnalyzeImageMission, FindAndLandMission
 from vehicle.cpp.build.libvehicle import VideoProvider, VideoStreamer,VideoRecorder
+from vehicle.cpp.build.libvehicle import TelemetryStore, MavlinkClient
 from common.python.logger import Logger
 from common.python.cmd_server import CMDServer
 from common.python.types import CMDTypes
-from mission_executer import execute_mission
+from mission_executer import execute_mission, abort_mission
 import time
 import datetime
 import os
@@ -22,6 +23,7 @@ def parse_arguments():
     parser.add_argument('vehicle_connection_string', help="E.g. /dev/ttyACM0 or /dev/ttyUSB0,57600")
     parser.add_argument('gcs_ip', help="Mention the GCS ip to make a UDP connection with it")
     parser.add_argument('--record', help="Record the video from the camera", default=False, const=True, action='store_const')
+    parser.add_argument('--mavlink_port', help="Local UDP port the autopilot streams MAVLink to, for the native setpoints of the missions", type=int, default=None)
     return parser.parse_args()
 
 def connect_to_vehicle(vehical_connection_string):
@@ -44,13 +46,13 @@ def on_demo_command(args):
     mission_thread.start()
 
 def on_coarse_scan_command(args):
-    mission = CoarseScanMission(float(args["alt"]), float(args["distance"]), float(args["j"]))
+    mission = CoarseScanMission(float(args["alt"]), float(args["distance"]), float(args["j"]), str(args.get("detector", "vectorizer")))
     mission_thread = Thread(target=execute_mission, args=[mission])
     mission_thread.setDaemon(True)
     mission_thread.start()
 
 def on_find_and_land_mission(args):
-    mission = FindAndLandMission(float(args["alt"]), float(args["distance"]), float(args["j"]))
+    mission = FindAndLandMission(float(args["alt"]), float(args["distance"]), float(args["j"]), str(args.get("detector", "vectorizer")), float(args.get("control_rate", 30)))
     mission_thread = Thread(target=execute_mission, args=[mission])
     mission_thread.setDaemon(True)
     mission_thread.start()
@@ -69,6 +71,7 @@ def on_up_down_command(args):
 
 def on_abort_command(args):
     Logger.info("Got abort command from user", TAG)
+    abort_mission()
     vehicle_control.get().abort()
 
 def on_ping(args):
@@ -91,6 +94,16 @@ if __name__ == "__main__":
     ServiceProvider.get_instance().publish("logger", Logger);
     ServiceProvider.get_instance().publish("vehicle_control", vehicle_control.get());
 
+    # Feed the telemetry of the vehicle to the missions, natively when the autopilot streams MAVLink to us
+    if args.mavlink_port:
+        mavlink_client = MavlinkClient("0.0.0.0", args.mavlink_port)
+        mavlink_client.publish_as_cpp_service("mavlink")
+        mavlink_client.start()
+    else:
+        telemetry_thread = Thread(target=vehicle_control.get().feed_telemetry, args=[TelemetryStore.get_instance()])
+        telemetry_thread.setDaemon(True)
+        telemetry_thread.start()
+
     # Setup Video provider
     video_provider = VideoProvider.get_instance()
     video_provider_thread = Thread(target=video_provider.start_listen_to_camera)
@@ -144,4 +157,6 @@ if __name__ == "__main__":
             video_provider_thread.join()
             video_streamer.stop_sending_video()
             video_streamer_thread.join()
+            if args.mavlink_port:
+                mavlink_client.stop()
             exit()
@@ -5,10 +5,13 @@ from threading import Lock
 TAG = "MissionExecuter"
 
 mission_lock = Lock()
+current_mission = None
 
 # mission should have a 'start' method
 def execute_mission(mission):
+    global current_mission
     if mission_lock.acquire(0):
+        current_mission = mission
         try:
             if not vehicle_control.get().arm():
                 Logger.warn("Could not arm vehicle. Will not start mission", TAG)
@@ -18,7 +21,14 @@ def execute_mission(mission):
             Logger.critical("Cpp module threw exception: {0}. Aborting!", TAG)
             vehicle_control.abort()
         finally:
+            current_mission = None
             vehicle_control.get().disarm()
             mission_lock.release()
     else:
-        Logger.warn("Already executing a mission", TAG)
\ No newline at end of file
+        Logger.warn("Already executing a mission", TAG)
+
+# mission should have an 'abort' method , the running mission goes to its abort state right away
+def abort_mission():
+    mission = current_mission
+    if mission is not None:
+        mission.abort()
@@ -11,6 +11,7 @@ AIR_SPEED = 3
 GROUND_SPEED = 3
 DEFAULT_TIMEOUT = 5
 DEFAULT_GAP = 0.5
+TELEMETRY_UPDATE_PERIOD = 0.05  # same as TELEMETRY_UPDATE_PERIOD of the C++ TelemetryStore
 DISTANCE_FROM_TARGET_THRESHOLD = 2
 MINIMUM_ALTITUDE_FACTOR = 0.95
 MAXIMUM_ALTITUDE_FACTOR = 1.15
@@ -40,6 +41,17 @@ class _VehicleControl:
         else:
             return self.vehicle.location.global_relative_frame.alt
 
+    # pushes the state of the vehicle to the C++ TelemetryStore so the missions can read it without the GIL
+    def feed_telemetry(self, telemetry_store):
+        while True:
+            attitude = self.vehicle.attitude
+            location = self.vehicle.location.global_relative_frame
+            velocity = self.vehicle.velocity or [0, 0, 0]
+            rangefinder = self.vehicle.rangefinder.distance or 0
+            telemetry_store.update(attitude.roll or 0, attitude.pitch or 0, attitude.yaw or 0, location.alt or 0, rangefinder,
+                                   location.lat or 0, location.lon or 0, velocity[0] or 0, velocity[1] or 0, velocity[2] or 0)
+            sleep(TELEMETRY_UPDATE_PERIOD)
+
     def get_roll_angle(self):
         return self.vehicle.attitude.roll
 